@@ -0,0 +1,210 @@
+/**
+ * @file acquisition.h
+ * @brief Parallel acquisition with one worker thread per bus
+ *
+ * Each bus gets a worker thread that owns it exclusively: the worker makes
+ * the bus its thread-local default backend, brings up its sensors and polls
+ * them at a fixed period. Since bus and driver state are thread-local (see
+ * I2C_TOOLS_THREAD_LOCAL), workers share nothing and never lock; the same
+ * driver can run on several buses at once.
+ *
+ * Workers hand samples to the consumer through single-producer
+ * single-consumer rings. acquisition_merge() interleaves the rings into one
+ * stream ordered by timestamp. A sample is only released once no bus can
+ * still produce an older one: every worker publishes a watermark, a time
+ * below which it will produce nothing more.
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef ACQUISITION_H
+#define ACQUISITION_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "i2c_tools.h"
+#include <pthread.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** @brief Maximum number of buses */
+#define ACQUISITION_MAX_BUSES (8)
+/** @brief Default ring capacity per bus, in samples (power of two) */
+#define ACQUISITION_DEFAULT_RING (4096)
+/** @brief Largest number of samples a single poll may return */
+#define ACQUISITION_MAX_POLL (64)
+
+/**
+ * @brief Sample channels
+ */
+typedef enum {
+  ACQUISITION_ENV = 0,  /**< BME280: temperature (C), pressure (Pa), RH (%) */
+  ACQUISITION_ACCE = 1, /**< MPU6050 accelerometer: x, y, z in g */
+  ACQUISITION_GYRO = 2, /**< MPU6050 gyroscope: x, y, z in deg/s */
+} acquisition_channel_t;
+
+/**
+ * @brief Timestamped sample from any bus
+ */
+typedef struct {
+  uint64_t timestamp_ns; /**< Acquisition time, CLOCK_MONOTONIC */
+  uint8_t bus;           /**< Index of the bus in the start configuration */
+  uint8_t channel;       /**< acquisition_channel_t */
+  uint8_t reserved[2];   /**< Zero */
+  float value[3];        /**< Channel values */
+} acquisition_sample_t;
+
+/**
+ * @brief Sensor bring-up, called once in the worker thread
+ * @return 0 on success, the worker stops otherwise
+ */
+typedef int (*acquisition_setup_t)(void *user);
+
+/**
+ * @brief Read the sensors of a bus, called every period in the worker
+ *
+ * Samples must come out in timestamp order, and no sample may be older
+ * than the start of the call minus the bus latency_us.
+ *
+ * @return Samples written, at most max
+ */
+typedef size_t (*acquisition_poll_t)(void *user, acquisition_sample_t *samples,
+                                     size_t max);
+
+/**
+ * @brief Configuration of one bus
+ */
+typedef struct {
+  const i2c_tools_backend_t *backend; /**< Bus, NULL for bcm2835 */
+  acquisition_setup_t setup;          /**< Bring-up, may be NULL */
+  acquisition_poll_t poll;            /**< Sensor read */
+  void *user;                         /**< Passed to setup and poll */
+  uint32_t period_us;                 /**< Poll period, non-zero */
+  uint32_t latency_us; /**< How far back a polled timestamp may lie (FIFO) */
+} acquisition_bus_t;
+
+/**
+ * @brief Worker states
+ */
+typedef enum {
+  ACQUISITION_STARTING = 0, /**< Bringing up its sensors */
+  ACQUISITION_RUNNING = 1,  /**< Polling */
+  ACQUISITION_FAILED = 2,   /**< Setup failed, the bus produces nothing */
+  ACQUISITION_STOPPED = 3,  /**< Exited */
+} acquisition_state_t;
+
+/**
+ * @brief Per-bus worker, producer side of one ring
+ */
+typedef struct {
+  alignas(64) _Atomic size_t tail; /**< Written by the worker only */
+  alignas(64) _Atomic size_t head; /**< Written by the consumer only */
+  alignas(64) _Atomic uint64_t watermark; /**< Lower bound of future stamps */
+  _Atomic int state;                      /**< acquisition_state_t */
+  _Atomic uint64_t produced;              /**< Samples pushed */
+  _Atomic uint64_t dropped;               /**< Samples lost to a full ring */
+  acquisition_sample_t *ring;             /**< Sample storage */
+  size_t mask;                            /**< Capacity - 1 */
+  acquisition_bus_t config;               /**< Bus configuration */
+  uint8_t index;                          /**< Bus index */
+  const _Atomic int *running;             /**< Owner's run flag */
+  pthread_t thread;                       /**< Worker thread */
+} acquisition_worker_t;
+
+/**
+ * @brief Acquisition instance
+ */
+typedef struct {
+  acquisition_worker_t worker[ACQUISITION_MAX_BUSES]; /**< One per bus */
+  size_t count;                                       /**< Buses in use */
+  _Atomic int running;                                /**< Cleared on stop */
+} acquisition_t;
+
+/**
+ * @brief Start one worker per bus
+ * @param acq Instance, must stay at the same address until stopped
+ * @param buses Bus configurations, copied
+ * @param count Number of buses, at most ACQUISITION_MAX_BUSES
+ * @param ring_capacity Samples per ring, rounded up to a power of two,
+ *        0 for ACQUISITION_DEFAULT_RING
+ * @return 0 on success, -1 on error (including a bus without a poll
+ *         function or with a zero period)
+ */
+int acquisition_start(acquisition_t *acq, const acquisition_bus_t *buses,
+                      size_t count, size_t ring_capacity);
+
+/**
+ * @brief Take samples from all buses in timestamp order
+ *
+ * Never blocks. Returns fewer samples than available when a slower bus
+ * might still produce older ones; they come out on a later call.
+ *
+ * @param acq Instance
+ * @param samples Destination
+ * @param max Capacity of samples
+ * @return Number of samples written
+ */
+size_t acquisition_merge(acquisition_t *acq, acquisition_sample_t *samples,
+                         size_t max);
+
+/**
+ * @brief Counters of one bus
+ * @param acq Instance
+ * @param bus Bus index
+ * @param produced Samples pushed by the worker, may be NULL
+ * @param dropped Samples lost because the ring was full, may be NULL
+ * @return acquisition_state_t of the worker, -1 if bus is not started
+ */
+int acquisition_stats(acquisition_t *acq, size_t bus, uint64_t *produced,
+                      uint64_t *dropped);
+
+/**
+ * @brief Stop and join the workers, release the rings
+ *
+ * Samples still queued are discarded; merge first to keep them.
+ *
+ * @param acq Instance
+ */
+void acquisition_stop(acquisition_t *acq);
+
+/**
+ * @brief Ready-made setup/poll pair for the BME280 and MPU6050
+ *
+ * Put one of these in acquisition_bus_t.user with acquisition_sensors_setup
+ * and acquisition_sensors_poll to read whichever of the two sensors sit on
+ * that bus.
+ */
+typedef struct {
+  uint8_t bme280_addr;    /**< BME280 address, 0 if absent */
+  uint8_t mpu6050_addr;   /**< MPU6050 address, 0 if absent */
+  const char *calib_path; /**< Saved MPU6050 offsets, may be NULL */
+  uint32_t env_every;     /**< Read the BME280 every N polls, 0 = 1 */
+  uint32_t polls;         /**< Poll counter, internal */
+} acquisition_sensors_t;
+
+/**
+ * @brief Bring up the sensors listed in an acquisition_sensors_t
+ * @param user acquisition_sensors_t
+ * @return 0 on success, -1 on error
+ */
+int acquisition_sensors_setup(void *user);
+
+/**
+ * @brief Read the sensors listed in an acquisition_sensors_t
+ * @param user acquisition_sensors_t
+ * @param samples Destination
+ * @param max Capacity, at least 3
+ * @return Samples written
+ */
+size_t acquisition_sensors_poll(void *user, acquisition_sample_t *samples,
+                                size_t max);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // ACQUISITION_H
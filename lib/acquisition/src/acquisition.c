@@ -0,0 +1,205 @@
+/**
+ * @file acquisition.c
+ * @brief Per-bus workers, SPSC rings and the timestamp merge
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <acquisition.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <trace.h>
+
+static uint64_t acquisition_now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void acquisition_push(acquisition_worker_t *w,
+                             const acquisition_sample_t *samples, size_t n) {
+  size_t tail = atomic_load_explicit(&w->tail, memory_order_relaxed);
+  size_t head = atomic_load_explicit(&w->head, memory_order_acquire);
+  size_t room = w->mask + 1 - (tail - head);
+  if (n > room) {
+    // The consumer fell behind; keep what is queued, lose the newest
+    atomic_fetch_add_explicit(&w->dropped, n - room, memory_order_relaxed);
+    n = room;
+  }
+  for (size_t i = 0; i < n; i++) {
+    acquisition_sample_t *slot = &w->ring[(tail + i) & w->mask];
+    *slot = samples[i];
+    slot->bus = w->index;
+  }
+  atomic_store_explicit(&w->tail, tail + n, memory_order_release);
+  atomic_fetch_add_explicit(&w->produced, n, memory_order_relaxed);
+}
+
+static void *acquisition_worker(void *arg) {
+  acquisition_worker_t *w = (acquisition_worker_t *)arg;
+  const acquisition_bus_t *bus = &w->config;
+
+  // This thread owns the bus: it becomes the thread-local default backend
+  i2c_tools_set_backend(bus->backend);
+#ifdef COREFLIGHT_TRACE
+  char name[TRACE_THREAD_NAME_MAX];
+  snprintf(name, sizeof(name), "acquisition-%u", w->index);
+  trace_thread_name(name);
+#endif
+  if (bus->setup != NULL && bus->setup(bus->user) != 0) {
+    fprintf(stderr, "Error bringing up bus %u\n", w->index);
+    atomic_store_explicit(&w->watermark, UINT64_MAX, memory_order_release);
+    atomic_store_explicit(&w->state, ACQUISITION_FAILED,
+                          memory_order_release);
+    return NULL;
+  }
+  atomic_store_explicit(&w->state, ACQUISITION_RUNNING, memory_order_release);
+
+  acquisition_sample_t batch[ACQUISITION_MAX_POLL];
+  uint64_t last_ns = 0;
+  uint64_t period_ns = (uint64_t)bus->period_us * 1000ULL;
+  uint64_t latency_ns = (uint64_t)bus->latency_us * 1000ULL;
+  uint64_t next_ns = acquisition_now_ns();
+
+  while (atomic_load_explicit(w->running, memory_order_relaxed)) {
+    uint64_t start_ns = acquisition_now_ns();
+    TRACE_BEGIN(poll);
+    size_t n = bus->poll(bus->user, batch, ACQUISITION_MAX_POLL);
+    TRACE_END(poll, "acquisition_poll", n);
+    if (n > 0) {
+      acquisition_push(w, batch, n);
+      last_ns = batch[n - 1].timestamp_ns;
+    }
+    // Later polls start after start_ns and may backdate by latency_ns only.
+    // Published after the samples so a reader that sees it also sees them.
+    uint64_t floor_ns = start_ns > latency_ns ? start_ns - latency_ns : 0;
+    atomic_store_explicit(&w->watermark, last_ns > floor_ns ? last_ns
+                                                            : floor_ns,
+                          memory_order_release);
+
+    next_ns += period_ns;
+    uint64_t now_ns = acquisition_now_ns();
+    if (next_ns < now_ns) {
+      // Overran: restart the schedule rather than bursting to catch up
+      next_ns = now_ns;
+      continue;
+    }
+    struct timespec deadline = {(time_t)(next_ns / 1000000000ULL),
+                                (long)(next_ns % 1000000000ULL)};
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL);
+  }
+
+  i2c_tool_cleanup();
+  atomic_store_explicit(&w->watermark, UINT64_MAX, memory_order_release);
+  atomic_store_explicit(&w->state, ACQUISITION_STOPPED, memory_order_release);
+  return NULL;
+}
+
+int acquisition_start(acquisition_t *acq, const acquisition_bus_t *buses,
+                      size_t count, size_t ring_capacity) {
+  memset(acq, 0, sizeof(*acq));
+  if (count == 0 || count > ACQUISITION_MAX_BUSES) {
+    return -1;
+  }
+  size_t capacity = 1;
+  while (capacity <
+         (ring_capacity != 0 ? ring_capacity : ACQUISITION_DEFAULT_RING)) {
+    capacity <<= 1;
+  }
+
+  atomic_store(&acq->running, 1);
+  for (size_t i = 0; i < count; i++) {
+    acquisition_worker_t *w = &acq->worker[i];
+    if (buses[i].poll == NULL || buses[i].period_us == 0) {
+      fprintf(stderr, "Error bus %zu needs a poll function and a period\n", i);
+      acquisition_stop(acq);
+      return -1;
+    }
+    w->ring = calloc(capacity, sizeof(*w->ring));
+    if (w->ring == NULL) {
+      fprintf(stderr, "Error allocating the ring of bus %zu\n", i);
+      acquisition_stop(acq);
+      return -1;
+    }
+    w->mask = capacity - 1;
+    w->config = buses[i];
+    w->index = (uint8_t)i;
+    w->running = &acq->running;
+    if (pthread_create(&w->thread, NULL, acquisition_worker, w) != 0) {
+      fprintf(stderr, "Error starting the worker of bus %zu\n", i);
+      free(w->ring);
+      w->ring = NULL;
+      acquisition_stop(acq);
+      return -1;
+    }
+    acq->count = i + 1;
+  }
+  return 0;
+}
+
+size_t acquisition_merge(acquisition_t *acq, acquisition_sample_t *samples,
+                         size_t max) {
+  TRACE_BEGIN(merge);
+  size_t n = 0;
+  while (n < max) {
+    acquisition_worker_t *best = NULL;
+    uint64_t best_ns = UINT64_MAX;
+    uint64_t horizon_ns = UINT64_MAX;
+
+    for (size_t i = 0; i < acq->count; i++) {
+      acquisition_worker_t *w = &acq->worker[i];
+      // Watermark before tail: if the watermark covers a sample, so does tail
+      uint64_t watermark =
+          atomic_load_explicit(&w->watermark, memory_order_acquire);
+      size_t tail = atomic_load_explicit(&w->tail, memory_order_acquire);
+      size_t head = atomic_load_explicit(&w->head, memory_order_relaxed);
+      if (head != tail) {
+        uint64_t ts = w->ring[head & w->mask].timestamp_ns;
+        if (ts < best_ns) {
+          best_ns = ts;
+          best = w;
+        }
+      } else if (watermark < horizon_ns) {
+        horizon_ns = watermark;
+      }
+    }
+    if (best == NULL || best_ns > horizon_ns) {
+      break;
+    }
+
+    size_t head = atomic_load_explicit(&best->head, memory_order_relaxed);
+    samples[n++] = best->ring[head & best->mask];
+    atomic_store_explicit(&best->head, head + 1, memory_order_release);
+  }
+  TRACE_END(merge, "acquisition_merge", n);
+  return n;
+}
+
+int acquisition_stats(acquisition_t *acq, size_t bus, uint64_t *produced,
+                      uint64_t *dropped) {
+  if (bus >= acq->count) {
+    return -1;
+  }
+  acquisition_worker_t *w = &acq->worker[bus];
+  if (produced != NULL) {
+    *produced = atomic_load_explicit(&w->produced, memory_order_relaxed);
+  }
+  if (dropped != NULL) {
+    *dropped = atomic_load_explicit(&w->dropped, memory_order_relaxed);
+  }
+  return atomic_load_explicit(&w->state, memory_order_acquire);
+}
+
+void acquisition_stop(acquisition_t *acq) {
+  atomic_store(&acq->running, 0);
+  for (size_t i = 0; i < acq->count; i++) {
+    pthread_join(acq->worker[i].thread, NULL);
+    free(acq->worker[i].ring);
+    acq->worker[i].ring = NULL;
+  }
+  acq->count = 0;
+}
@@ -0,0 +1,81 @@
+/**
+ * @file acquisition_sensors.c
+ * @brief BME280/MPU6050 setup and poll callbacks for acquisition workers
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <acquisition.h>
+#include <bme280.h>
+#include <mpu6050.h>
+#include <mpu6050_calib.h>
+#include <string.h>
+
+int acquisition_sensors_setup(void *user) {
+  acquisition_sensors_t *sensors = (acquisition_sensors_t *)user;
+  sensors->polls = 0;
+  if (sensors->bme280_addr != 0 && bme280_begin(sensors->bme280_addr) != 0) {
+    return -1;
+  }
+  if (sensors->mpu6050_addr != 0) {
+    if (mpu6050_begin(sensors->mpu6050_addr) != 0) {
+      return -1;
+    }
+    mpu6050_set_acce_fs(MPU6050_RANGE_4_G);
+    mpu6050_set_gyro_fs(MPU6050_RANGE_500_DEG);
+    // Offsets live in thread-local driver state, apply them in this worker
+    mpu6050_calib_data_t calib;
+    if (sensors->calib_path != NULL &&
+        mpu6050_calib_load(sensors->calib_path, &calib) == 0) {
+      mpu6050_calib_apply(&calib, MPU6050_CALIB_APPLY_DRIVER);
+    }
+  }
+  return 0;
+}
+
+static void acquisition_sensors_emit(acquisition_sample_t *sample,
+                                     acquisition_channel_t channel,
+                                     uint64_t timestamp_ns, float x, float y,
+                                     float z) {
+  memset(sample, 0, sizeof(*sample));
+  sample->timestamp_ns = timestamp_ns;
+  sample->channel = (uint8_t)channel;
+  sample->value[0] = x;
+  sample->value[1] = y;
+  sample->value[2] = z;
+}
+
+size_t acquisition_sensors_poll(void *user, acquisition_sample_t *samples,
+                                size_t max) {
+  acquisition_sensors_t *sensors = (acquisition_sensors_t *)user;
+  size_t n = 0;
+  uint32_t every = sensors->env_every != 0 ? sensors->env_every : 1;
+
+  // Read in bus order so the samples come out in timestamp order
+  if (sensors->mpu6050_addr != 0 && n + 2 <= max) {
+    mpu6050_acce_value_t acce;
+    mpu6050_gyro_value_t gyro;
+    if (mpu6050_get_acce(&acce) == 0) {
+      acquisition_sensors_emit(&samples[n++], ACQUISITION_ACCE,
+                               acce.timestamp_ns, acce.acce_x, acce.acce_y,
+                               acce.acce_z);
+    }
+    if (mpu6050_get_gyro(&gyro) == 0) {
+      acquisition_sensors_emit(&samples[n++], ACQUISITION_GYRO,
+                               gyro.timestamp_ns, gyro.gyro_x, gyro.gyro_y,
+                               gyro.gyro_z);
+    }
+  }
+  if (sensors->bme280_addr != 0 && n < max &&
+      sensors->polls++ % every == 0) {
+    bme280_sample_t env;
+    if (bme280_read_sample(&env) == 0) {
+      acquisition_sensors_emit(&samples[n++], ACQUISITION_ENV,
+                               env.timestamp_ns, env.temperature,
+                               env.pressure, env.humidity);
+    }
+  }
+  return n;
+}
@@ -0,0 +1,110 @@
+/**
+ * @file attitude.h
+ * @brief Incremental roll/pitch estimator for the MPU6050
+ *
+ * Fuses accelerometer and gyroscope samples into a complimentary_angle_t
+ * with a complementary filter, or optionally with a Mahony quaternion
+ * filter. Each update is constant time and allocation free, and the time
+ * step is taken from the sample timestamps.
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef ATTITUDE_H
+#define ATTITUDE_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "mpu6050.h"
+#include <stddef.h>
+
+/** @brief Worst-case error of the fast-math atan2 approximation (degrees) */
+#define ATTITUDE_FAST_MATH_MAX_ERROR_DEG (0.09f)
+
+/** @brief Largest time step accepted between two samples (seconds) */
+#define ATTITUDE_MAX_DT_S (0.5f)
+
+/**
+ * @brief Estimator algorithm
+ */
+typedef enum {
+  ATTITUDE_COMPLEMENTARY = 0, /**< Roll/pitch complementary filter */
+  ATTITUDE_MAHONY = 1         /**< Mahony quaternion filter */
+} attitude_mode_t;
+
+/**
+ * @brief Estimator configuration
+ */
+typedef struct {
+  attitude_mode_t mode; /**< Estimator algorithm */
+  float alpha;          /**< Gyro weight of the complementary filter (0-1) */
+  float kp;             /**< Mahony proportional gain */
+  float ki;             /**< Mahony integral gain */
+  int fast_math;        /**< Use the bounded-error atan2 approximation */
+} attitude_config_t;
+
+/**
+ * @brief Estimator state
+ */
+typedef struct {
+  attitude_config_t config;    /**< Active configuration */
+  complimentary_angle_t angle; /**< Latest roll/pitch in degrees */
+  float q[4];                  /**< Orientation quaternion (w, x, y, z) */
+  float integral[3];           /**< Mahony integral feedback (rad/s) */
+  uint64_t last_ns;            /**< Timestamp of the previous sample */
+  int initialized;             /**< Non-zero once seeded from gravity */
+} attitude_t;
+
+/**
+ * @brief Fill a configuration with sensible defaults
+ * @param config Configuration to fill
+ */
+void attitude_default_config(attitude_config_t *config);
+
+/**
+ * @brief Initialize the estimator
+ * @param att Estimator state
+ * @param config Configuration, or NULL for the defaults
+ */
+void attitude_init(attitude_t *att, const attitude_config_t *config);
+
+/**
+ * @brief Update the estimate with one accelerometer/gyroscope sample
+ * @param att Estimator state
+ * @param acce Accelerometer sample in g
+ * @param gyro Gyroscope sample in deg/s, its timestamp drives the time step
+ */
+void attitude_update(attitude_t *att, const mpu6050_acce_value_t *acce,
+                     const mpu6050_gyro_value_t *gyro);
+
+/**
+ * @brief Update the estimate with a block of samples, e.g. a FIFO drain
+ * @param att Estimator state
+ * @param acce Accelerometer samples in g
+ * @param gyro Gyroscope samples in deg/s
+ * @param count Number of samples
+ */
+void attitude_update_batch(attitude_t *att, const mpu6050_acce_value_t *acce,
+                           const mpu6050_gyro_value_t *gyro, size_t count);
+
+/**
+ * @brief Get the latest roll/pitch estimate
+ * @param att Estimator state
+ * @param angle Destination, in degrees
+ */
+void attitude_get_angle(const attitude_t *att, complimentary_angle_t *angle);
+
+/**
+ * @brief Get the latest orientation quaternion (Mahony mode only)
+ * @param att Estimator state
+ * @param q Destination quaternion (w, x, y, z)
+ */
+void attitude_get_quaternion(const attitude_t *att, float q[4]);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // ATTITUDE_H
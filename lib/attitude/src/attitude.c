@@ -0,0 +1,241 @@
+/**
+ * @file attitude.c
+ * @brief Implementation of the incremental roll/pitch estimator
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <attitude.h>
+#include <math.h>
+#include <stdint.h>
+
+#define ATTITUDE_PI (3.14159265358979f)
+#define ATTITUDE_DEG_TO_RAD (ATTITUDE_PI / 180.0f)
+#define ATTITUDE_RAD_TO_DEG (180.0f / ATTITUDE_PI)
+
+/**
+ * @brief Polynomial atan2 approximation
+ *
+ * Uses atan(z) ~ pi/4 z - z(|z| - 1)(0.2447 + 0.0663|z|) on the first octant
+ * and folds the other octants onto it; the error stays below
+ * ATTITUDE_FAST_MATH_MAX_ERROR_DEG.
+ */
+static float attitude_fast_atan2(float y, float x) {
+  float abs_x = fabsf(x);
+  float abs_y = fabsf(y);
+  float max = abs_x > abs_y ? abs_x : abs_y;
+  float min = abs_x > abs_y ? abs_y : abs_x;
+  if (max == 0.0f) {
+    return 0.0f;
+  }
+
+  float z = min / max;
+  float r = (ATTITUDE_PI / 4.0f) * z - z * (z - 1.0f) * (0.2447f + 0.0663f * z);
+  if (abs_y > abs_x) {
+    r = (ATTITUDE_PI / 2.0f) - r;
+  }
+  if (x < 0.0f) {
+    r = ATTITUDE_PI - r;
+  }
+  return y < 0.0f ? -r : r;
+}
+
+static float attitude_atan2(const attitude_t *att, float y, float x) {
+  return att->config.fast_math ? attitude_fast_atan2(y, x) : atan2f(y, x);
+}
+
+/**
+ * @brief Wrap an angle in degrees into (-180, 180]
+ */
+static float attitude_wrap(float angle) {
+  if (angle > 180.0f) {
+    angle -= 360.0f;
+  } else if (angle <= -180.0f) {
+    angle += 360.0f;
+  }
+  return angle;
+}
+
+/**
+ * @brief Roll/pitch seen by the accelerometer, assuming it only measures g
+ */
+static void attitude_gravity_angle(const attitude_t *att,
+                                   const mpu6050_acce_value_t *acce,
+                                   complimentary_angle_t *angle) {
+  float ay = acce->acce_y;
+  float az = acce->acce_z;
+  angle->roll = attitude_atan2(att, ay, az) * ATTITUDE_RAD_TO_DEG;
+  angle->pitch = attitude_atan2(att, -acce->acce_x, sqrtf(ay * ay + az * az)) *
+                 ATTITUDE_RAD_TO_DEG;
+}
+
+/**
+ * @brief Seed the quaternion from roll/pitch with zero yaw
+ */
+static void attitude_seed_quaternion(attitude_t *att) {
+  float half_roll = att->angle.roll * ATTITUDE_DEG_TO_RAD * 0.5f;
+  float half_pitch = att->angle.pitch * ATTITUDE_DEG_TO_RAD * 0.5f;
+  float cr = cosf(half_roll), sr = sinf(half_roll);
+  float cp = cosf(half_pitch), sp = sinf(half_pitch);
+
+  att->q[0] = cr * cp;
+  att->q[1] = sr * cp;
+  att->q[2] = cr * sp;
+  att->q[3] = -sr * sp;
+}
+
+static void attitude_complementary_step(attitude_t *att,
+                                        const complimentary_angle_t *measured,
+                                        const mpu6050_gyro_value_t *gyro,
+                                        float dt) {
+  float weight = 1.0f - att->config.alpha;
+  float roll = att->angle.roll + gyro->gyro_x * dt;
+  float pitch = att->angle.pitch + gyro->gyro_y * dt;
+
+  att->angle.roll =
+      attitude_wrap(roll + weight * attitude_wrap(measured->roll - roll));
+  att->angle.pitch =
+      attitude_wrap(pitch + weight * attitude_wrap(measured->pitch - pitch));
+}
+
+static void attitude_mahony_step(attitude_t *att,
+                                 const mpu6050_acce_value_t *acce,
+                                 const mpu6050_gyro_value_t *gyro, float dt) {
+  float *q = att->q;
+  float gx = gyro->gyro_x * ATTITUDE_DEG_TO_RAD;
+  float gy = gyro->gyro_y * ATTITUDE_DEG_TO_RAD;
+  float gz = gyro->gyro_z * ATTITUDE_DEG_TO_RAD;
+  float ax = acce->acce_x, ay = acce->acce_y, az = acce->acce_z;
+
+  float norm = ax * ax + ay * ay + az * az;
+  if (norm > 0.0f) {
+    norm = 1.0f / sqrtf(norm);
+    ax *= norm;
+    ay *= norm;
+    az *= norm;
+
+    // Gravity direction predicted by the current orientation
+    float vx = 2.0f * (q[1] * q[3] - q[0] * q[2]);
+    float vy = 2.0f * (q[0] * q[1] + q[2] * q[3]);
+    float vz = q[0] * q[0] - q[1] * q[1] - q[2] * q[2] + q[3] * q[3];
+
+    // Error is the cross product between measured and predicted gravity
+    float ex = ay * vz - az * vy;
+    float ey = az * vx - ax * vz;
+    float ez = ax * vy - ay * vx;
+
+    if (att->config.ki > 0.0f) {
+      att->integral[0] += att->config.ki * ex * dt;
+      att->integral[1] += att->config.ki * ey * dt;
+      att->integral[2] += att->config.ki * ez * dt;
+    }
+    gx += att->config.kp * ex + att->integral[0];
+    gy += att->config.kp * ey + att->integral[1];
+    gz += att->config.kp * ez + att->integral[2];
+  }
+
+  gx *= 0.5f * dt;
+  gy *= 0.5f * dt;
+  gz *= 0.5f * dt;
+  float q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3];
+  q[0] += -q1 * gx - q2 * gy - q3 * gz;
+  q[1] += q0 * gx + q2 * gz - q3 * gy;
+  q[2] += q0 * gy - q1 * gz + q3 * gx;
+  q[3] += q0 * gz + q1 * gy - q2 * gx;
+
+  norm = 1.0f / sqrtf(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+  q[0] *= norm;
+  q[1] *= norm;
+  q[2] *= norm;
+  q[3] *= norm;
+
+  float sin_pitch = 2.0f * (q[0] * q[2] - q[3] * q[1]);
+  if (sin_pitch > 1.0f) {
+    sin_pitch = 1.0f;
+  } else if (sin_pitch < -1.0f) {
+    sin_pitch = -1.0f;
+  }
+  att->angle.roll = attitude_atan2(att, 2.0f * (q[0] * q[1] + q[2] * q[3]),
+                                   1.0f - 2.0f * (q[1] * q[1] + q[2] * q[2])) *
+                    ATTITUDE_RAD_TO_DEG;
+  att->angle.pitch =
+      attitude_atan2(att, sin_pitch, sqrtf(1.0f - sin_pitch * sin_pitch)) *
+      ATTITUDE_RAD_TO_DEG;
+}
+
+void attitude_default_config(attitude_config_t *config) {
+  config->mode = ATTITUDE_COMPLEMENTARY;
+  config->alpha = 0.98f;
+  config->kp = 1.0f;
+  config->ki = 0.0f;
+  config->fast_math = 0;
+}
+
+void attitude_init(attitude_t *att, const attitude_config_t *config) {
+  if (config != NULL) {
+    att->config = *config;
+  } else {
+    attitude_default_config(&att->config);
+  }
+  att->angle.roll = 0.0f;
+  att->angle.pitch = 0.0f;
+  att->q[0] = 1.0f;
+  att->q[1] = 0.0f;
+  att->q[2] = 0.0f;
+  att->q[3] = 0.0f;
+  att->integral[0] = 0.0f;
+  att->integral[1] = 0.0f;
+  att->integral[2] = 0.0f;
+  att->last_ns = 0;
+  att->initialized = 0;
+}
+
+void attitude_update(attitude_t *att, const mpu6050_acce_value_t *acce,
+                     const mpu6050_gyro_value_t *gyro) {
+  if (!att->initialized) {
+    // First sample: trust gravity alone
+    attitude_gravity_angle(att, acce, &att->angle);
+    attitude_seed_quaternion(att);
+    att->last_ns = gyro->timestamp_ns;
+    att->initialized = 1;
+    return;
+  }
+
+  // Out-of-order or stale samples only contribute their gravity reference
+  float dt = 0.0f;
+  if (gyro->timestamp_ns > att->last_ns) {
+    dt = (float)(gyro->timestamp_ns - att->last_ns) * 1e-9f;
+    if (dt > ATTITUDE_MAX_DT_S) {
+      dt = 0.0f;
+    }
+    att->last_ns = gyro->timestamp_ns;
+  }
+
+  if (att->config.mode == ATTITUDE_MAHONY) {
+    attitude_mahony_step(att, acce, gyro, dt);
+  } else {
+    complimentary_angle_t measured;
+    attitude_gravity_angle(att, acce, &measured);
+    attitude_complementary_step(att, &measured, gyro, dt);
+  }
+}
+
+void attitude_update_batch(attitude_t *att, const mpu6050_acce_value_t *acce,
+                           const mpu6050_gyro_value_t *gyro, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    attitude_update(att, &acce[i], &gyro[i]);
+  }
+}
+
+void attitude_get_angle(const attitude_t *att, complimentary_angle_t *angle) {
+  *angle = att->angle;
+}
+
+void attitude_get_quaternion(const attitude_t *att, float q[4]) {
+  q[0] = att->q[0];
+  q[1] = att->q[1];
+  q[2] = att->q[2];
+  q[3] = att->q[3];
+}
@@ -26,6 +26,21 @@ extern "C" {
 /** @brief Alternate I2C address for BME280 */
 #define BME280_ADDRESS_ALTERNATE (0x76)
 
+/** @brief Chip ID of the BME280 */
+#define BME280_CHIP_ID (0x60)
+
+/** @brief Chip ID of the BMP280, register compatible without humidity */
+#define BMP280_CHIP_ID (0x58)
+
+/** @brief Start-up time after power-on or soft reset (datasheet, µs) */
+#define BME280_STARTUP_US (2000)
+
+/** @brief Poll interval while the NVM calibration copy runs (µs) */
+#define BME280_NVM_POLL_US (100)
+
+/** @brief Give up on the NVM copy after this long (µs) */
+#define BME280_NVM_TIMEOUT_US (20000)
+
 /** @brief Standard sea-level pressure in hPa */
 #define SEALEVELPRESSURE_HPA (1013.25)
 
@@ -106,7 +121,7 @@ enum sensor_sampling {
 enum sensor_mode {
   MODE_SLEEP = 0,  /**< Sleep mode */
   MODE_FORCED = 1, /**< Forced mode */
-  MODE_NORMAL = 2  /**< Normal mode */
+  MODE_NORMAL = 3  /**< Normal mode (0b11, 0b01 and 0b10 are forced) */
 };
 
 /**
@@ -143,7 +158,7 @@ struct config_reg {
   unsigned int none : 1;     /**< Unused bit */
   unsigned int spi3w_en : 1; /**< SPI 3-wire enable */
 };
-extern struct config_reg configReg;
+extern I2C_TOOLS_THREAD_LOCAL struct config_reg configReg;
 
 /**
  * @brief Control measurement register structure
@@ -153,7 +168,7 @@ struct ctrl_meas {
   unsigned int osrs_p : 3; /**< Pressure oversampling */
   unsigned int mode : 2;   /**< Device mode */
 };
-extern struct ctrl_meas meas_reg;
+extern I2C_TOOLS_THREAD_LOCAL struct ctrl_meas meas_reg;
 
 /**
  * @brief Control humidity register structure
@@ -162,7 +177,79 @@ struct ctrl_hum {
   unsigned int none : 5;   /**< Unused bits */
   unsigned int osrs_h : 3; /**< Humidity oversampling */
 };
-extern struct ctrl_hum hum_reg;
+extern I2C_TOOLS_THREAD_LOCAL struct ctrl_hum hum_reg;
+
+/**
+ * @brief Timestamped BME280 measurement
+ */
+typedef struct {
+  uint64_t timestamp_ns; /**< Monotonic time the sample was latched (ns) */
+  float temperature;     /**< Temperature in degrees Celsius (°C) */
+  float pressure;        /**< Pressure in pascals (Pa) */
+  float humidity;        /**< Relative humidity in percentage (%) */
+} bme280_sample_t;
+
+/** @brief Bytes of the calibration block at 0x88..0xA1 */
+#define BME280_CALIB_TP_SIZE (26)
+
+/** @brief Bytes of the calibration block at 0xE1..0xE7 */
+#define BME280_CALIB_H_SIZE (7)
+
+/**
+ * @brief Decode the two raw calibration blocks
+ * @param tp BME280_CALIB_TP_SIZE bytes read from 0x88
+ * @param h BME280_CALIB_H_SIZE bytes read from 0xE1
+ * @param calib Destination
+ */
+void bme280_parse_calibration(const uint8_t *tp, const uint8_t *h,
+                              bme280_calib_data_t *calib);
+
+/**
+ * @brief Fine temperature shared by all three compensations
+ * @param calib Calibration of the sensor
+ * @param adc_T 20-bit raw temperature value
+ * @return t_fine as defined by the datasheet
+ */
+int32_t bme280_calc_t_fine(const bme280_calib_data_t *calib, int32_t adc_T);
+
+/**
+ * @brief Temperature from the fine temperature
+ * @param t_fine Result of bme280_calc_t_fine()
+ * @return Temperature in degrees Celsius (°C)
+ */
+float bme280_calc_temperature(int32_t t_fine);
+
+/**
+ * @brief Compensate a raw pressure reading
+ * @param calib Calibration of the sensor
+ * @param t_fine Result of bme280_calc_t_fine() for the same measurement
+ * @param adc_P 20-bit raw pressure value
+ * @return Pressure in pascals (Pa)
+ */
+float bme280_calc_pressure(const bme280_calib_data_t *calib, int32_t t_fine,
+                          int32_t adc_P);
+
+/**
+ * @brief Compensate a raw humidity reading
+ * @param calib Calibration of the sensor
+ * @param t_fine Result of bme280_calc_t_fine() for the same measurement
+ * @param adc_H 16-bit raw humidity value
+ * @return Relative humidity in percentage (%)
+ */
+float bme280_calc_humidity(const bme280_calib_data_t *calib, int32_t t_fine,
+                          int32_t adc_H);
+
+/**
+ * @brief Select the transport the sensor is wired to
+ *
+ * Call before bme280_begin(). The driver activates this backend on every
+ * call, so the BME280 can sit on SPI (see spi_tools) while other drivers keep
+ * using the default I2C bus. Register addressing differences are handled by
+ * the transport; slave addresses are ignored on SPI.
+ *
+ * @param transport Backend to use, NULL for the default I2C backend
+ */
+void bme280_set_bus(const i2c_tools_backend_t *transport);
 
 /**
  * @brief Initialize and configure the BME280 sensor
@@ -171,6 +258,39 @@ extern struct ctrl_hum hum_reg;
  */
 int bme280_begin(uint8_t slave);
 
+/**
+ * @brief Soft-reset the sensor on an already initialized bus
+ *
+ * First half of bme280_begin() for callers that bring several devices up
+ * at once: it returns right after the reset command, and
+ * bme280_configure() waits out whatever is left of the start-up time.
+ *
+ * @param slave I2C address of the sensor (0x76 or 0x77)
+ * @return 0 on success, negative value on error
+ */
+int bme280_start(uint8_t slave);
+
+/**
+ * @brief Load the calibration and start normal-mode measurements
+ *
+ * Waits for the reset start-up time and the NVM copy, then configures the
+ * sensor. Does not wait for the first conversion, see bme280_ready_ns().
+ *
+ * @return 0 on success, negative value on error
+ */
+int bme280_configure(void);
+
+/**
+ * @brief Time the pending start-up phase ends
+ *
+ * After bme280_start() this is the end of the reset start-up time, after
+ * bme280_configure() the time the first conversion is complete (worst case
+ * from the datasheet for the configured oversampling).
+ *
+ * @return Monotonic time in nanoseconds
+ */
+uint64_t bme280_ready_ns(void);
+
 /**
  * @brief Read compensated temperature from the BME280
  * @return Temperature in degrees Celsius (°C)
@@ -179,7 +299,7 @@ float bme280_read_temperature(void);
 
 /**
  * @brief Read compensated pressure from the BME280
- * @return Pressure in hectopascals (hPa)
+ * @return Pressure in pascals (Pa)
  */
 float bme280_read_pressure(void);
 
@@ -196,6 +316,13 @@ float bme280_read_altitude(float seaLevel);
  */
 float bme280_read_humidity(void);
 
+/**
+ * @brief Read temperature, pressure and humidity in one burst transaction
+ * @param sample Destination sample, stamped with the monotonic read time
+ * @return 0 on success, negative value on error
+ */
+int bme280_read_sample(bme280_sample_t *sample);
+
 #ifdef __cplusplus
 }
 #endif
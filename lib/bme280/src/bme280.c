@@ -16,30 +16,39 @@
 #include <math.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <trace.h>
 
 /** @brief Calibration data for the BME280 */
-static bme280_calib_data_t bme280_calib;
+static I2C_TOOLS_THREAD_LOCAL bme280_calib_data_t bme280_calib;
 
 /** @brief Fine temperature value used for compensation calculations */
-static int32_t t_fine;
+static I2C_TOOLS_THREAD_LOCAL int32_t t_fine;
 
 /** @brief Adjustment for temperature readings (affects pressure and humidity)
  */
-static int32_t t_fine_adjust = 0;
+static I2C_TOOLS_THREAD_LOCAL int32_t t_fine_adjust = 0;
 
-/** @brief Global configuration registers */
-struct config_reg configReg;
-struct ctrl_meas meas_reg;
-struct ctrl_hum hum_reg;
+/** @brief Configuration registers of this thread's sensor */
+I2C_TOOLS_THREAD_LOCAL struct config_reg configReg;
+I2C_TOOLS_THREAD_LOCAL struct ctrl_meas meas_reg;
+I2C_TOOLS_THREAD_LOCAL struct ctrl_hum hum_reg;
 
-static uint8_t slave_addr = 0x0;
+static I2C_TOOLS_THREAD_LOCAL uint8_t slave_addr = 0x0;
+
+/** @brief Time the next start-up phase may proceed (monotonic ns) */
+static I2C_TOOLS_THREAD_LOCAL uint64_t ready_ns = 0;
+
+/** @brief Transport of the sensor, NULL for the default I2C backend */
+static I2C_TOOLS_THREAD_LOCAL const i2c_tools_backend_t *bus = NULL;
+
+void bme280_set_bus(const i2c_tools_backend_t *transport) { bus = transport; }
 
 /**
  * @brief Perform a soft reset of the BME280
  * @return 0 on success, negative value on error
  */
 static int bme280_reset(void) {
-  i2c_tools_set_slave_address(slave_addr);
+  i2c_tools_select(bus, slave_addr);
   // Write 0xB6 to the soft reset register (0xE0)
   int ret = i2c_tool_write_reg(BME280_REGISTER_SOFTRESET, 0xB6);
   if (ret != 0) {
@@ -54,47 +63,67 @@ static int bme280_reset(void) {
  * @return Non-zero if calibration is in progress, 0 otherwise
  */
 static int bme280_in_calibration(void) {
-  i2c_tools_set_slave_address(slave_addr);
+  i2c_tools_select(bus, slave_addr);
   uint8_t buffer = i2c_tool_read_byte(BME280_REGISTER_STATUS);
   return (buffer & (1 << 0)) != 0;
 }
 
+void bme280_parse_calibration(const uint8_t *c, const uint8_t *e,
+                              bme280_calib_data_t *calib) {
+  calib->dig_T1 = (uint16_t)(c[0] | c[1] << 8);
+  calib->dig_T2 = (int16_t)(c[2] | c[3] << 8);
+  calib->dig_T3 = (int16_t)(c[4] | c[5] << 8);
+
+  calib->dig_P1 = (uint16_t)(c[6] | c[7] << 8);
+  calib->dig_P2 = (int16_t)(c[8] | c[9] << 8);
+  calib->dig_P3 = (int16_t)(c[10] | c[11] << 8);
+  calib->dig_P4 = (int16_t)(c[12] | c[13] << 8);
+  calib->dig_P5 = (int16_t)(c[14] | c[15] << 8);
+  calib->dig_P6 = (int16_t)(c[16] | c[17] << 8);
+  calib->dig_P7 = (int16_t)(c[18] | c[19] << 8);
+  calib->dig_P8 = (int16_t)(c[20] | c[21] << 8);
+  calib->dig_P9 = (int16_t)(c[22] | c[23] << 8);
+
+  // 0xA0 is unused, dig_H1 sits at 0xA1
+  calib->dig_H1 = c[25];
+  calib->dig_H2 = (int16_t)(e[0] | e[1] << 8);
+  calib->dig_H3 = e[2];
+  // dig_H4 and dig_H5 are 12-bit values sharing the nibbles of 0xE5
+  calib->dig_H4 = (int16_t)((int8_t)e[3] * 16 | (e[4] & 0xF));
+  calib->dig_H5 = (int16_t)((int8_t)e[5] * 16 | (e[4] >> 4));
+  calib->dig_H6 = (int8_t)e[6];
+}
+
 /**
  * @brief Read calibration coefficients from the BME280
+ *
+ * Two burst reads (0x88..0xA1 and 0xE1..0xE7) instead of one transaction
+ * per coefficient.
+ *
+ * @return 0 on success, negative value on error
  */
-static void bme280_read_coefficients(void) {
-  i2c_tools_set_slave_address(slave_addr);
-  bme280_calib.dig_T1 = i2c_tool_read16_le(BME280_REGISTER_DIG_T1);
-  bme280_calib.dig_T2 = i2c_tool_reads16_le(BME280_REGISTER_DIG_T2);
-  bme280_calib.dig_T3 = i2c_tool_reads16_le(BME280_REGISTER_DIG_T3);
-
-  bme280_calib.dig_P1 = i2c_tool_read16_le(BME280_REGISTER_DIG_P1);
-  bme280_calib.dig_P2 = i2c_tool_reads16_le(BME280_REGISTER_DIG_P2);
-  bme280_calib.dig_P3 = i2c_tool_reads16_le(BME280_REGISTER_DIG_P3);
-  bme280_calib.dig_P4 = i2c_tool_reads16_le(BME280_REGISTER_DIG_P4);
-  bme280_calib.dig_P5 = i2c_tool_reads16_le(BME280_REGISTER_DIG_P5);
-  bme280_calib.dig_P6 = i2c_tool_reads16_le(BME280_REGISTER_DIG_P6);
-  bme280_calib.dig_P7 = i2c_tool_reads16_le(BME280_REGISTER_DIG_P7);
-  bme280_calib.dig_P8 = i2c_tool_reads16_le(BME280_REGISTER_DIG_P8);
-  bme280_calib.dig_P9 = i2c_tool_reads16_le(BME280_REGISTER_DIG_P9);
-
-  bme280_calib.dig_H1 = i2c_tool_read_byte(BME280_REGISTER_DIG_H1);
-  bme280_calib.dig_H2 = i2c_tool_reads16_le(BME280_REGISTER_DIG_H2);
-  bme280_calib.dig_H3 = i2c_tool_read_byte(BME280_REGISTER_DIG_H3);
-  bme280_calib.dig_H4 =
-      ((int8_t)i2c_tool_read_byte(BME280_REGISTER_DIG_H4) << 4) |
-      (i2c_tool_read_byte(BME280_REGISTER_DIG_H4 + 1) & 0xF);
-  bme280_calib.dig_H5 =
-      ((int8_t)i2c_tool_read_byte(BME280_REGISTER_DIG_H5 + 1) << 4) |
-      (i2c_tool_read_byte(BME280_REGISTER_DIG_H5) >> 4);
-  bme280_calib.dig_H6 = (int8_t)i2c_tool_read_byte(BME280_REGISTER_DIG_H6);
+static int bme280_read_coefficients(void) {
+  i2c_tools_select(bus, slave_addr);
+  char tp[BME280_CALIB_TP_SIZE];
+  char h[BME280_CALIB_H_SIZE];
+  int ret = i2c_tools_read_reg(BME280_REGISTER_DIG_T1, tp, sizeof(tp));
+  if (ret != 0) {
+    return ret;
+  }
+  ret = i2c_tools_read_reg(BME280_REGISTER_DIG_H2, h, sizeof(h));
+  if (ret != 0) {
+    return ret;
+  }
+  bme280_parse_calibration((const uint8_t *)tp, (const uint8_t *)h,
+                           &bme280_calib);
+  return 0;
 }
 
 /**
  * @brief Configure sampling settings for the BME280
  */
 static void bme280_set_sampling(void) {
-  i2c_tools_set_slave_address(slave_addr);
+  i2c_tools_select(bus, slave_addr);
   meas_reg.mode = MODE_NORMAL;
   meas_reg.osrs_t = SAMPLING_X16;
   meas_reg.osrs_p = SAMPLING_X16;
@@ -118,13 +147,107 @@ static void bme280_set_sampling(void) {
   i2c_tool_write_reg(BME280_REGISTER_CONTROL, meas_data);
 }
 
+int32_t bme280_calc_t_fine(const bme280_calib_data_t *calib, int32_t adc_T) {
+  int32_t var1, var2;
+
+  var1 = (int32_t)((adc_T / 8) - ((int32_t)calib->dig_T1 * 2));
+  var1 = (var1 * ((int32_t)calib->dig_T2)) / 2048;
+  var2 = (int32_t)((adc_T / 16) - ((int32_t)calib->dig_T1));
+  var2 = (((var2 * var2) / 4096) * ((int32_t)calib->dig_T3)) / 16384;
+
+  return var1 + var2;
+}
+
+float bme280_calc_temperature(int32_t t_fine) {
+  int32_t T = (t_fine * 5 + 128) / 256;
+
+  return (float)T / 100;
+}
+
+float bme280_calc_pressure(const bme280_calib_data_t *calib, int32_t t_fine,
+                          int32_t adc_P) {
+  int64_t var1, var2, var3, var4;
+
+  var1 = ((int64_t)t_fine) - 128000;
+  var2 = var1 * var1 * (int64_t)calib->dig_P6;
+  var2 = var2 + ((var1 * (int64_t)calib->dig_P5) * 131072);
+  var2 = var2 + (((int64_t)calib->dig_P4) * 34359738368);
+  var1 = ((var1 * var1 * (int64_t)calib->dig_P3) / 256) +
+         ((var1 * ((int64_t)calib->dig_P2) * 4096));
+  var3 = ((int64_t)1) * 140737488355328;
+  var1 = (var3 + var1) * ((int64_t)calib->dig_P1) / 8589934592;
+
+  if (var1 == 0) {
+    return 0; // Avoid division by zero
+  }
+
+  var4 = 1048576 - adc_P;
+  var4 = (((var4 * 2147483648) - var2) * 3125) / var1;
+  var1 = (((int64_t)calib->dig_P9) * (var4 / 8192) * (var4 / 8192)) /
+         33554432;
+  var2 = (((int64_t)calib->dig_P8) * var4) / 524288;
+  var4 = ((var4 + var1 + var2) / 256) + (((int64_t)calib->dig_P7) * 16);
+
+  return (float)var4 / 256.0;
+}
+
+float bme280_calc_humidity(const bme280_calib_data_t *calib, int32_t t_fine,
+                          int32_t adc_H) {
+  int32_t var1, var2, var3, var4, var5;
+
+  var1 = t_fine - ((int32_t)76800);
+  var2 = (int32_t)(adc_H * 16384);
+  var3 = (int32_t)(((int32_t)calib->dig_H4) * 1048576);
+  var4 = ((int32_t)calib->dig_H5) * var1;
+  var5 = (((var2 - var3) - var4) + (int32_t)16384) / 32768;
+  var2 = (var1 * ((int32_t)calib->dig_H6)) / 1024;
+  var3 = (var1 * ((int32_t)calib->dig_H3)) / 2048;
+  var4 = ((var2 * (var3 + (int32_t)32768)) / 1024) + (int32_t)2097152;
+  var2 = ((var4 * ((int32_t)calib->dig_H2)) + 8192) / 16384;
+  var3 = var5 * var2;
+  var4 = ((var3 / 32768) * (var3 / 32768)) / 128;
+  var5 = var3 - ((var4 * ((int32_t)calib->dig_H1)) / 16);
+  var5 = (var5 < 0 ? 0 : var5);
+  var5 = (var5 > 419430400 ? 419430400 : var5);
+  uint32_t H = (uint32_t)(var5 / 4096);
+
+  return (float)H / 1024.0;
+}
+
+/**
+ * @brief Compensate a raw temperature reading and update t_fine
+ * @param adc_T 20-bit raw temperature value
+ * @return Temperature in degrees Celsius (°C)
+ */
+static float bme280_compensate_temperature(int32_t adc_T) {
+  t_fine = bme280_calc_t_fine(&bme280_calib, adc_T) + t_fine_adjust;
+  return bme280_calc_temperature(t_fine);
+}
+
+/**
+ * @brief Compensate a raw pressure reading using the current t_fine
+ * @param adc_P 20-bit raw pressure value
+ * @return Pressure in pascals (Pa)
+ */
+static float bme280_compensate_pressure(int32_t adc_P) {
+  return bme280_calc_pressure(&bme280_calib, t_fine, adc_P);
+}
+
+/**
+ * @brief Compensate a raw humidity reading using the current t_fine
+ * @param adc_H 16-bit raw humidity value
+ * @return Relative humidity in percentage (%)
+ */
+static float bme280_compensate_humidity(int32_t adc_H) {
+  return bme280_calc_humidity(&bme280_calib, t_fine, adc_H);
+}
+
 /**
  * @brief Read and compensate temperature from the BME280
  * @return Temperature in degrees Celsius (°C)
  */
 float bme280_read_temperature(void) {
-  i2c_tools_set_slave_address(slave_addr);
-  int32_t var1, var2;
+  i2c_tools_select(bus, slave_addr);
   if (meas_reg.osrs_t == SAMPLING_NONE) {
     return 0;
   }
@@ -132,24 +255,15 @@ float bme280_read_temperature(void) {
   int32_t adc_T = i2c_tool_read24(BME280_REGISTER_TEMPDATA);
   adc_T >>= 4;
 
-  var1 = (int32_t)((adc_T / 8) - ((int32_t)bme280_calib.dig_T1 * 2));
-  var1 = (var1 * ((int32_t)bme280_calib.dig_T2)) / 2048;
-  var2 = (int32_t)((adc_T / 16) - ((int32_t)bme280_calib.dig_T1));
-  var2 = (((var2 * var2) / 4096) * ((int32_t)bme280_calib.dig_T3)) / 16384;
-
-  t_fine = var1 + var2 + t_fine_adjust;
-  int32_t T = (t_fine * 5 + 128) / 256;
-
-  return (float)T / 100;
+  return bme280_compensate_temperature(adc_T);
 }
 
 /**
  * @brief Read and compensate pressure from the BME280
- * @return Pressure in hectopascals (hPa)
+ * @return Pressure in pascals (Pa)
  */
 float bme280_read_pressure(void) {
-  i2c_tools_set_slave_address(slave_addr);
-  int64_t var1, var2, var3, var4;
+  i2c_tools_select(bus, slave_addr);
   if (meas_reg.osrs_p == SAMPLING_NONE) {
     return 0;
   }
@@ -159,27 +273,7 @@ float bme280_read_pressure(void) {
   int32_t adc_P = i2c_tool_read24(BME280_REGISTER_PRESSUREDATA);
   adc_P >>= 4;
 
-  var1 = ((int64_t)t_fine) - 128000;
-  var2 = var1 * var1 * (int64_t)bme280_calib.dig_P6;
-  var2 = var2 + ((var1 * (int64_t)bme280_calib.dig_P5) * 131072);
-  var2 = var2 + (((int64_t)bme280_calib.dig_P4) * 34359738368);
-  var1 = ((var1 * var1 * (int64_t)bme280_calib.dig_P3) / 256) +
-         ((var1 * ((int64_t)bme280_calib.dig_P2) * 4096));
-  var3 = ((int64_t)1) * 140737488355328;
-  var1 = (var3 + var1) * ((int64_t)bme280_calib.dig_P1) / 8589934592;
-
-  if (var1 == 0) {
-    return 0; // Avoid division by zero
-  }
-
-  var4 = 1048576 - adc_P;
-  var4 = (((var4 * 2147483648) - var2) * 3125) / var1;
-  var1 = (((int64_t)bme280_calib.dig_P9) * (var4 / 8192) * (var4 / 8192)) /
-         33554432;
-  var2 = (((int64_t)bme280_calib.dig_P8) * var4) / 524288;
-  var4 = ((var4 + var1 + var2) / 256) + (((int64_t)bme280_calib.dig_P7) * 16);
-
-  return (float)var4 / 256.0;
+  return bme280_compensate_pressure(adc_P);
 }
 
 /**
@@ -188,7 +282,7 @@ float bme280_read_pressure(void) {
  * @return Altitude in meters
  */
 float bme280_read_altitude(float seaLevel) {
-  i2c_tools_set_slave_address(slave_addr);
+  i2c_tools_select(bus, slave_addr);
   float atmospheric = bme280_read_pressure() / 100.0F;
   return 44330.0 * (1.0 - pow(atmospheric / seaLevel, 0.1903));
 }
@@ -198,8 +292,7 @@ float bme280_read_altitude(float seaLevel) {
  * @return Relative humidity in percentage (%)
  */
 float bme280_read_humidity(void) {
-  i2c_tools_set_slave_address(slave_addr);
-  int32_t var1, var2, var3, var4, var5;
+  i2c_tools_select(bus, slave_addr);
   if (hum_reg.osrs_h == SAMPLING_NONE) {
     return 0;
   }
@@ -207,31 +300,58 @@ float bme280_read_humidity(void) {
   bme280_read_temperature(); // Required to update t_fine
 
   int32_t adc_H = i2c_tool_read16(BME280_REGISTER_HUMIDDATA);
-  var1 = t_fine - ((int32_t)76800);
-  var2 = (int32_t)(adc_H * 16384);
-  var3 = (int32_t)(((int32_t)bme280_calib.dig_H4) * 1048576);
-  var4 = ((int32_t)bme280_calib.dig_H5) * var1;
-  var5 = (((var2 - var3) - var4) + (int32_t)16384) / 32768;
-  var2 = (var1 * ((int32_t)bme280_calib.dig_H6)) / 1024;
-  var3 = (var1 * ((int32_t)bme280_calib.dig_H3)) / 2048;
-  var4 = ((var2 * (var3 + (int32_t)32768)) / 1024) + (int32_t)2097152;
-  var2 = ((var4 * ((int32_t)bme280_calib.dig_H2)) + 8192) / 16384;
-  var3 = var5 * var2;
-  var4 = ((var3 / 32768) * (var3 / 32768)) / 128;
-  var5 = var3 - ((var4 * ((int32_t)bme280_calib.dig_H1)) / 16);
-  var5 = (var5 < 0 ? 0 : var5);
-  var5 = (var5 > 419430400 ? 419430400 : var5);
-  uint32_t H = (uint32_t)(var5 / 4096);
+  return bme280_compensate_humidity(adc_H);
+}
 
-  return (float)H / 1024.0;
+/**
+ * @brief Read a timestamped temperature, pressure and humidity sample
+ *
+ * The three channels come from a single burst read of 0xF7..0xFE, so they
+ * belong to the same measurement cycle, and the timestamp is taken when the
+ * data registers were latched.
+ *
+ * @param sample Destination sample
+ * @return 0 on success, negative value on error
+ */
+int bme280_read_sample(bme280_sample_t *sample) {
+  TRACE_BEGIN(read);
+  i2c_tools_select(bus, slave_addr);
+  char buffer[8];
+  int ret = i2c_tools_read_reg(BME280_REGISTER_PRESSUREDATA, buffer, 8);
+  if (ret != 0) {
+    return ret;
+  }
+  sample->timestamp_ns = i2c_tools_last_timestamp_ns();
+  TRACE_BEGIN(compensate);
+
+  const uint8_t *data = (const uint8_t *)buffer;
+  int32_t adc_P = ((int32_t)data[0] << 12) | ((int32_t)data[1] << 4) |
+                  ((int32_t)data[2] >> 4);
+  int32_t adc_T = ((int32_t)data[3] << 12) | ((int32_t)data[4] << 4) |
+                  ((int32_t)data[5] >> 4);
+  int32_t adc_H = ((int32_t)data[6] << 8) | (int32_t)data[7];
+
+  sample->temperature = meas_reg.osrs_t == SAMPLING_NONE
+                            ? 0
+                            : bme280_compensate_temperature(adc_T);
+  sample->pressure = meas_reg.osrs_p == SAMPLING_NONE
+                         ? 0
+                         : bme280_compensate_pressure(adc_P);
+  sample->humidity = hum_reg.osrs_h == SAMPLING_NONE
+                         ? 0
+                         : bme280_compensate_humidity(adc_H);
+  TRACE_END(compensate, "bme280_compensate", 0);
+  TRACE_END(read, "bme280_read_sample", 0);
+  return 0;
 }
 
 /**
- * @brief Initialize the BME280 sensor
+ * @brief Initialize the bus and check the chip ID
  * @param slave I2C address of the sensor (0x76 or 0x77)
  * @return 0 on success, negative value on error
  */
 static int bme280_init(uint8_t slave) {
+  i2c_tools_use(bus);
   int ret = i2c_tools_init();
   if (ret != BCM2835_I2C_REASON_OK) {
     fprintf(stderr, "Error initializing I2C: %d\n", ret);
@@ -242,18 +362,11 @@ static int bme280_init(uint8_t slave) {
     fprintf(stderr, "Error starting I2C with slave 0x%02X: %d\n", slave, ret);
     return ret;
   }
-  slave_addr = slave;
-  ret = bme280_reset();
-  if (ret != 0) {
-    fprintf(stderr, "Error resetting BME280: %d\n", ret);
-    return ret;
-  }
-  bcm2835_delay(2); // Delay for reset (~2ms per datasheet)
 
   uint8_t chip_id = i2c_tool_read_byte(BME280_REGISTER_CHIPID);
-  if (chip_id == 0x60) {
+  if (chip_id == BME280_CHIP_ID) {
     printf("Success: BME280 detected\n");
-  } else if (chip_id == 0x58) {
+  } else if (chip_id == BMP280_CHIP_ID) {
     printf("Success: BMP280 detected\n");
   } else {
     printf("Warning: Expected chip ID 0x60 or 0x58, got 0x%02X\n", chip_id);
@@ -262,23 +375,79 @@ static int bme280_init(uint8_t slave) {
   return 0;
 }
 
+/**
+ * @brief Worst-case measurement time of the current settings
+ *
+ * Datasheet section 9.1: 1.25 ms + 2.3 ms per temperature oversample +
+ * 2.3 ms per pressure and humidity oversample plus 0.575 ms each.
+ *
+ * @return Measurement time in microseconds
+ */
+static uint32_t bme280_measure_time_us(void) {
+  static const uint8_t samples[] = {0, 1, 2, 4, 8, 16, 16, 16};
+  uint32_t t = samples[meas_reg.osrs_t];
+  uint32_t p = samples[meas_reg.osrs_p];
+  uint32_t h = samples[hum_reg.osrs_h];
+  return 1250 + 2300 * t + (p ? 2300 * p + 575 : 0) +
+         (h ? 2300 * h + 575 : 0);
+}
+
+int bme280_start(uint8_t slave) {
+  slave_addr = slave;
+  int ret = bme280_reset();
+  if (ret != 0) {
+    return ret;
+  }
+  ready_ns = i2c_tools_timestamp_ns() + BME280_STARTUP_US * 1000ULL;
+  return 0;
+}
+
+int bme280_configure(void) {
+  i2c_tools_select(bus, slave_addr);
+  uint64_t now = i2c_tools_timestamp_ns();
+  if (now < ready_ns) {
+    i2c_tools_delay_us((uint32_t)((ready_ns - now + 999) / 1000));
+  }
+
+  // The NVM copy takes a few hundred microseconds after the start-up time
+  uint32_t waited_us = 0;
+  while (bme280_in_calibration() != 0) {
+    if (waited_us >= BME280_NVM_TIMEOUT_US) {
+      fprintf(stderr, "Error BME280 NVM copy did not finish\n");
+      return -2;
+    }
+    i2c_tools_delay_us(BME280_NVM_POLL_US);
+    waited_us += BME280_NVM_POLL_US;
+  }
+
+  int ret = bme280_read_coefficients();
+  if (ret != 0) {
+    fprintf(stderr, "Error reading BME280 calibration: %d\n", ret);
+    return ret;
+  }
+  bme280_set_sampling();
+  ready_ns = i2c_tools_timestamp_ns() + bme280_measure_time_us() * 1000ULL;
+  return 0;
+}
+
+uint64_t bme280_ready_ns(void) { return ready_ns; }
+
 /**
  * @brief Initialize and configure the BME280 sensor
  * @param slave I2C address of the sensor (0x76 or 0x77)
  * @return 0 on success, negative value on error
  */
 int bme280_begin(uint8_t slave) {
-  if (bme280_init(slave) != 0) {
+  if (bme280_init(slave) != 0 || bme280_start(slave) != 0 ||
+      bme280_configure() != 0) {
     fprintf(stderr, "Error initializing BME280\n");
     return -1;
   }
 
-  while (bme280_in_calibration() != 0) {
-    bcm2835_delay(10);
+  // The first conversion must complete before the data registers are valid
+  uint64_t now = i2c_tools_timestamp_ns();
+  if (now < ready_ns) {
+    i2c_tools_delay_us((uint32_t)((ready_ns - now + 999) / 1000));
   }
-
-  bme280_read_coefficients();
-  bme280_set_sampling();
-  bcm2835_delay(100);
   return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,111 @@
+/**
+ * @file bringup.h
+ * @brief Sensor discovery and overlapped start-up on the default I2C bus
+ *
+ * Initializes the bus once, probes the known addresses for chip IDs and
+ * brings up the first BME280/BMP280 and MPU6050 found. Both devices are
+ * reset/woken back to back so their start-up times run concurrently, and
+ * every wait is the datasheet figure for the configured settings rather
+ * than a fixed sleep. Each phase is timed so the time to first sample can
+ * be tracked against a budget.
+ *
+ * Start-up is split in two so the caller can do its own work (loading
+ * calibration files, setting ranges) while the sensors settle:
+ *
+ *   bringup_t b;
+ *   bringup_start(&b);
+ *   ...
+ *   bringup_wait(&b);
+ *
+ * The drivers keep one device of each kind per thread; further devices
+ * found by the scan are listed but left untouched.
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef BRINGUP_H
+#define BRINGUP_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "bme280.h"
+#include "mpu6050.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/** @brief Largest device table, one entry per probed address */
+#define BRINGUP_MAX_DEVICES (4)
+
+/**
+ * @brief Kinds of device the scan recognizes
+ */
+typedef enum {
+  BRINGUP_BME280,  /**< Chip ID 0x60 at 0x76/0x77 */
+  BRINGUP_BMP280,  /**< Chip ID 0x58 at 0x76/0x77 */
+  BRINGUP_MPU6050  /**< WHO_AM_I 0x68 at 0x68/0x69 */
+} bringup_device_type_t;
+
+/**
+ * @brief Device found on the bus
+ */
+typedef struct {
+  bringup_device_type_t type; /**< Kind of device */
+  uint8_t address;            /**< 7-bit I2C address */
+  uint8_t chip_id;            /**< Value read from the ID register */
+} bringup_device_t;
+
+/**
+ * @brief Duration of each start-up phase (ns)
+ */
+typedef struct {
+  uint64_t bus_ns;       /**< Bus initialization */
+  uint64_t scan_ns;      /**< Chip ID probing */
+  uint64_t reset_ns;     /**< Reset and wake-up commands */
+  uint64_t configure_ns; /**< BME280 start-up wait, NVM copy, settings */
+  uint64_t settle_ns;    /**< Wait in bringup_wait() for the first sample */
+  uint64_t total_ns;     /**< bringup_start() to the end of bringup_wait() */
+} bringup_timings_t;
+
+/**
+ * @brief Bring-up state and results
+ */
+typedef struct {
+  bringup_device_t devices[BRINGUP_MAX_DEVICES]; /**< Scan results */
+  size_t count;                /**< Entries in devices */
+  int env;                     /**< Device started as the BME280, or -1 */
+  int imu;                     /**< Device started as the MPU6050, or -1 */
+  uint64_t start_ns;           /**< When bringup_start() was called */
+  bringup_timings_t timings;   /**< Phase durations */
+} bringup_t;
+
+/**
+ * @brief Initialize the bus, scan it and start the sensors found
+ *
+ * Returns once both sensors are configured; their first samples are not
+ * valid until bringup_wait() returns.
+ *
+ * @param bringup State, filled in
+ * @return Number of sensors started, -1 if the bus could not be
+ *         initialized or a sensor failed to start
+ */
+int bringup_start(bringup_t *bringup);
+
+/**
+ * @brief Wait until every started sensor delivers valid samples
+ * @param bringup State from bringup_start()
+ */
+void bringup_wait(bringup_t *bringup);
+
+/**
+ * @brief Print the device table and phase timings to stdout
+ * @param bringup State from bringup_start()/bringup_wait()
+ */
+void bringup_report(const bringup_t *bringup);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // BRINGUP_H
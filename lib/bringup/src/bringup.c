@@ -0,0 +1,144 @@
+/**
+ * @file bringup.c
+ * @brief Sensor discovery and overlapped start-up on the default I2C bus
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <bringup.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @brief Read an ID register, -1 if nothing acknowledges the address
+ */
+static int bringup_probe(uint8_t address, uint8_t reg) {
+  if (i2c_tools_set_slave_address(address) != 0) {
+    return -1;
+  }
+  char id;
+  if (i2c_tools_read_reg(reg, &id, 1) != 0) {
+    return -1;
+  }
+  return (uint8_t)id;
+}
+
+static void bringup_scan(bringup_t *bringup) {
+  static const uint8_t env_addresses[] = {BME280_ADDRESS_ALTERNATE,
+                                          BME280_ADDRESS};
+  static const uint8_t imu_addresses[] = {MPU6050_ADDRESS,
+                                          MPU6050_ADDRESS_ALTERNATE};
+
+  for (size_t i = 0; i < sizeof(env_addresses); i++) {
+    int id = bringup_probe(env_addresses[i], BME280_REGISTER_CHIPID);
+    if (id != BME280_CHIP_ID && id != BMP280_CHIP_ID) {
+      continue;
+    }
+    bringup_device_t *dev = &bringup->devices[bringup->count];
+    dev->type = id == BME280_CHIP_ID ? BRINGUP_BME280 : BRINGUP_BMP280;
+    dev->address = env_addresses[i];
+    dev->chip_id = (uint8_t)id;
+    if (bringup->env < 0) {
+      bringup->env = (int)bringup->count;
+    }
+    bringup->count++;
+  }
+
+  for (size_t i = 0; i < sizeof(imu_addresses); i++) {
+    int id = bringup_probe(imu_addresses[i], MPU6050_WHO_AM_I);
+    if (id != MPU6050_CHIP_ID) {
+      continue;
+    }
+    bringup_device_t *dev = &bringup->devices[bringup->count];
+    dev->type = BRINGUP_MPU6050;
+    dev->address = imu_addresses[i];
+    dev->chip_id = (uint8_t)id;
+    if (bringup->imu < 0) {
+      bringup->imu = (int)bringup->count;
+    }
+    bringup->count++;
+  }
+}
+
+int bringup_start(bringup_t *bringup) {
+  memset(bringup, 0, sizeof(*bringup));
+  bringup->env = -1;
+  bringup->imu = -1;
+  bringup->start_ns = i2c_tools_timestamp_ns();
+
+  i2c_tools_use(NULL);
+  int ret = i2c_tools_init();
+  if (ret != BCM2835_I2C_REASON_OK) {
+    fprintf(stderr, "Error initializing I2C: %d\n", ret);
+    return -1;
+  }
+  uint64_t t_bus = i2c_tools_timestamp_ns();
+  bringup->timings.bus_ns = t_bus - bringup->start_ns;
+
+  bringup_scan(bringup);
+  uint64_t t_scan = i2c_tools_timestamp_ns();
+  bringup->timings.scan_ns = t_scan - t_bus;
+
+  // Issue both resets first so the start-up times overlap
+  if (bringup->env >= 0) {
+    bme280_set_bus(NULL);
+    if (bme280_start(bringup->devices[bringup->env].address) != 0) {
+      fprintf(stderr, "Error resetting BME280\n");
+      return -1;
+    }
+  }
+  if (bringup->imu >= 0) {
+    mpu6050_set_bus(NULL);
+    if (mpu6050_start(bringup->devices[bringup->imu].address) != 0) {
+      fprintf(stderr, "Error waking up MPU6050\n");
+      return -1;
+    }
+  }
+  uint64_t t_reset = i2c_tools_timestamp_ns();
+  bringup->timings.reset_ns = t_reset - t_scan;
+
+  if (bringup->env >= 0 && bme280_configure() != 0) {
+    fprintf(stderr, "Error configuring BME280\n");
+    return -1;
+  }
+  bringup->timings.configure_ns = i2c_tools_timestamp_ns() - t_reset;
+
+  return (bringup->env >= 0) + (bringup->imu >= 0);
+}
+
+void bringup_wait(bringup_t *bringup) {
+  uint64_t ready = 0;
+  if (bringup->env >= 0 && bme280_ready_ns() > ready) {
+    ready = bme280_ready_ns();
+  }
+  if (bringup->imu >= 0 && mpu6050_ready_ns() > ready) {
+    ready = mpu6050_ready_ns();
+  }
+
+  uint64_t now = i2c_tools_timestamp_ns();
+  if (now < ready) {
+    i2c_tools_delay_us((uint32_t)((ready - now + 999) / 1000));
+  }
+  uint64_t end = i2c_tools_timestamp_ns();
+  bringup->timings.settle_ns = end - now;
+  bringup->timings.total_ns = end - bringup->start_ns;
+}
+
+void bringup_report(const bringup_t *bringup) {
+  static const char *names[] = {"BME280", "BMP280", "MPU6050"};
+  for (size_t i = 0; i < bringup->count; i++) {
+    const bringup_device_t *dev = &bringup->devices[i];
+    int used = (int)i == bringup->env || (int)i == bringup->imu;
+    printf("[BOOT] %s at 0x%02X (id 0x%02X)%s\n", names[dev->type],
+           dev->address, dev->chip_id, used ? "" : " unused");
+  }
+  const bringup_timings_t *t = &bringup->timings;
+  printf("[BOOT] bus %" PRIu64 " us, scan %" PRIu64 " us, reset %" PRIu64
+         " us, configure %" PRIu64 " us, settle %" PRIu64 " us, total %" PRIu64
+         " us\n",
+         t->bus_ns / 1000, t->scan_ns / 1000, t->reset_ns / 1000,
+         t->configure_ns / 1000, t->settle_ns / 1000, t->total_ns / 1000);
+}
@@ -0,0 +1,135 @@
+/**
+ * @file decimator.h
+ * @brief Multi-channel anti-alias FIR decimator
+ *
+ * Low-pass filters and downsamples several channels sharing one sample
+ * clock (the six IMU axes, or the three BME280 outputs) by an integer
+ * ratio. Only the kept outputs are computed, so the cost per input sample
+ * is taps / ratio multiply-adds per channel, the polyphase figure.
+ *
+ * The history is stored frame-major with the channels padded to
+ * DECIMATOR_LANES, which turns the inner loop into a fixed-width vector
+ * multiply-add the compiler maps onto SSE/NEON. All memory is allocated by
+ * decimator_init(); decimator_process() never allocates.
+ *
+ * Stages compose: feed the output of one into another for large ratios
+ * (1 kHz -> /5 -> /4 = 50 Hz needs far fewer taps than a single /20). The
+ * same stage on the BME280 channels replaces the on-chip IIR filter
+ * (FILTER_X16) with a linear-phase one whose delay is known exactly.
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef DECIMATOR_H
+#define DECIMATOR_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** @brief Maximum channels per stage */
+#define DECIMATOR_MAX_CHANNELS (8)
+/** @brief Channel stride of the history, a whole number of vectors */
+#define DECIMATOR_LANES (8)
+
+/**
+ * @brief Stage configuration
+ */
+typedef struct {
+  size_t channels;       /**< Channels, 1..DECIMATOR_MAX_CHANNELS */
+  size_t ratio;          /**< Keep one output every ratio inputs, >= 1 */
+  size_t taps_per_phase; /**< Filter length / ratio, longer = sharper */
+  float cutoff;          /**< -6 dB point as a fraction of the output
+                              Nyquist frequency, (0, 1] */
+} decimator_config_t;
+
+/**
+ * @brief Stage state
+ */
+typedef struct {
+  size_t channels; /**< Channels */
+  size_t ratio;    /**< Decimation ratio */
+  size_t taps;     /**< Filter length */
+  float *coeffs;   /**< Time-reversed impulse response, taps entries */
+  float *history;  /**< 2 * taps frames of DECIMATOR_LANES floats */
+  uint64_t *times; /**< Input timestamps, taps entries */
+  size_t pos;      /**< Oldest frame of the window */
+  size_t phase;    /**< Inputs since the last output */
+  int primed;      /**< History seeded from the first input */
+} decimator_t;
+
+/**
+ * @brief Default configuration: 16 taps per phase, -6 dB at 60 %
+ *
+ * The transition band ends below the output Nyquist frequency, so nothing
+ * folds back: about -0.4 dB at 40 % of output Nyquist, below -60 dB from
+ * 92 % and about -75 dB across the whole stop band.
+ *
+ * @param config Destination
+ * @param channels Channel count
+ * @param ratio Decimation ratio
+ */
+void decimator_default_config(decimator_config_t *config, size_t channels,
+                              size_t ratio);
+
+/**
+ * @brief Design the filter and allocate the stage
+ *
+ * The response is a Blackman-windowed sinc normalised to unity DC gain, so
+ * slowly varying signals such as pressure pass through unchanged.
+ *
+ * @param dec Stage
+ * @param config Configuration
+ * @return 0 on success, -1 on invalid configuration or allocation failure
+ */
+int decimator_init(decimator_t *dec, const decimator_config_t *config);
+
+/**
+ * @brief Filter and decimate a block of samples
+ *
+ * The first input seeds the whole history, so there is no start-up ramp
+ * from zero, and produces the first output. Until taps / 2 inputs have been
+ * seen the output timestamps repeat the first input timestamp.
+ *
+ * @param dec Stage
+ * @param in One array of count samples per channel
+ * @param in_ts Input timestamps, may be NULL
+ * @param count Input samples per channel
+ * @param out One array per channel, room for count / ratio + 1 samples
+ * @param out_ts Output timestamps, may be NULL. Each is the timestamp of
+ *        the input at the filter centre, or the mean of the two middle
+ *        inputs when the filter length is even, so the group delay is
+ *        already compensated (to the nanosecond, rounded down).
+ * @return Number of output samples written per channel
+ */
+size_t decimator_process(decimator_t *dec, const float *const *in,
+                         const uint64_t *in_ts, size_t count,
+                         float *const *out, uint64_t *out_ts);
+
+/**
+ * @brief Group delay of the stage
+ * @param dec Stage
+ * @return Delay in input samples
+ */
+float decimator_group_delay(const decimator_t *dec);
+
+/**
+ * @brief Forget the history, the next input seeds it again
+ * @param dec Stage
+ */
+void decimator_reset(decimator_t *dec);
+
+/**
+ * @brief Release the stage memory
+ * @param dec Stage
+ */
+void decimator_free(decimator_t *dec);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // DECIMATOR_H
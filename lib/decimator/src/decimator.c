@@ -0,0 +1,159 @@
+/**
+ * @file decimator.c
+ * @brief Multi-channel anti-alias FIR decimator
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <decimator.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <trace.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+void decimator_default_config(decimator_config_t *config, size_t channels,
+                              size_t ratio) {
+  config->channels = channels;
+  config->ratio = ratio;
+  config->taps_per_phase = 16;
+  config->cutoff = 0.6f;
+}
+
+/**
+ * @brief Blackman-windowed sinc with unity DC gain, stored time-reversed
+ */
+static void decimator_design(float *coeffs, size_t taps, double fc) {
+  double sum = 0;
+  double centre = (double)(taps - 1) / 2.0;
+  for (size_t k = 0; k < taps; k++) {
+    double t = (double)k - centre;
+    double sinc = t == 0 ? 2 * fc : sin(2 * M_PI * fc * t) / (M_PI * t);
+    double w = taps == 1 ? 1.0
+                         : 0.42 - 0.5 * cos(2 * M_PI * k / (taps - 1)) +
+                               0.08 * cos(4 * M_PI * k / (taps - 1));
+    coeffs[taps - 1 - k] = (float)(sinc * w);
+    sum += sinc * w;
+  }
+  for (size_t k = 0; k < taps; k++) {
+    coeffs[k] = (float)(coeffs[k] / sum);
+  }
+}
+
+int decimator_init(decimator_t *dec, const decimator_config_t *config) {
+  memset(dec, 0, sizeof(*dec));
+  if (config->channels == 0 || config->channels > DECIMATOR_MAX_CHANNELS ||
+      config->ratio == 0 || config->taps_per_phase == 0 ||
+      !(config->cutoff > 0 && config->cutoff <= 1)) {
+    return -1;
+  }
+  dec->channels = config->channels;
+  dec->ratio = config->ratio;
+  dec->taps = config->ratio * config->taps_per_phase;
+
+  dec->coeffs = malloc(dec->taps * sizeof(float));
+  dec->history = calloc(2 * dec->taps * DECIMATOR_LANES, sizeof(float));
+  dec->times = calloc(dec->taps, sizeof(uint64_t));
+  if (dec->coeffs == NULL || dec->history == NULL || dec->times == NULL) {
+    decimator_free(dec);
+    return -1;
+  }
+  // Cut-off in cycles per input sample: output Nyquist is 0.5 / ratio
+  decimator_design(dec->coeffs, dec->taps,
+                   config->cutoff * 0.5 / (double)config->ratio);
+  return 0;
+}
+
+static void decimator_write(decimator_t *dec, size_t frame, const float *x,
+                            uint64_t ts) {
+  // Every frame is stored twice so any window of taps frames is contiguous
+  float *a = &dec->history[frame * DECIMATOR_LANES];
+  float *b = &dec->history[(frame + dec->taps) * DECIMATOR_LANES];
+  memcpy(a, x, DECIMATOR_LANES * sizeof(float));
+  memcpy(b, x, DECIMATOR_LANES * sizeof(float));
+  dec->times[frame] = ts;
+}
+
+size_t decimator_process(decimator_t *dec, const float *const *in,
+                         const uint64_t *in_ts, size_t count,
+                         float *const *out, uint64_t *out_ts) {
+  TRACE_BEGIN(process);
+  const size_t taps = dec->taps;
+  const size_t channels = dec->channels;
+  size_t produced = 0;
+
+  for (size_t i = 0; i < count; i++) {
+    float x[DECIMATOR_LANES] = {0};
+    for (size_t c = 0; c < channels; c++) {
+      x[c] = in[c][i];
+    }
+    uint64_t ts = in_ts != NULL ? in_ts[i] : 0;
+
+    if (!dec->primed) {
+      for (size_t k = 0; k < taps; k++) {
+        decimator_write(dec, k, x, ts);
+      }
+      dec->pos = 0;
+      dec->phase = dec->ratio - 1;
+      dec->primed = 1;
+    } else {
+      // The oldest frame is replaced by the newest one
+      decimator_write(dec, dec->pos, x, ts);
+      dec->pos = dec->pos + 1 == taps ? 0 : dec->pos + 1;
+    }
+
+    if (++dec->phase < dec->ratio) {
+      continue;
+    }
+    dec->phase = 0;
+
+    float acc[DECIMATOR_LANES] = {0};
+    const float *window = &dec->history[dec->pos * DECIMATOR_LANES];
+    for (size_t k = 0; k < taps; k++) {
+      const float h = dec->coeffs[k];
+      const float *frame = &window[k * DECIMATOR_LANES];
+      for (size_t lane = 0; lane < DECIMATOR_LANES; lane++) {
+        acc[lane] += h * frame[lane];
+      }
+    }
+    for (size_t c = 0; c < channels; c++) {
+      out[c][produced] = acc[c];
+    }
+    if (out_ts != NULL) {
+      // With an even length the centre falls between two inputs: average
+      // them rather than take the earlier one half a sample early
+      size_t lo = dec->pos + (taps - 1) / 2;
+      size_t hi = dec->pos + taps / 2;
+      uint64_t a = dec->times[lo >= taps ? lo - taps : lo];
+      uint64_t b = dec->times[hi >= taps ? hi - taps : hi];
+      out_ts[produced] = (a >> 1) + (b >> 1) + (a & b & 1);
+    }
+    produced++;
+  }
+  TRACE_END(process, "decimate", count);
+  return produced;
+}
+
+float decimator_group_delay(const decimator_t *dec) {
+  return (float)(dec->taps - 1) / 2.0f;
+}
+
+void decimator_reset(decimator_t *dec) {
+  dec->primed = 0;
+  dec->pos = 0;
+  dec->phase = 0;
+}
+
+void decimator_free(decimator_t *dec) {
+  free(dec->coeffs);
+  free(dec->history);
+  free(dec->times);
+  dec->coeffs = NULL;
+  dec->history = NULL;
+  dec->times = NULL;
+}
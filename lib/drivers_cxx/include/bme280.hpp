@@ -0,0 +1,314 @@
+/**
+ * @file bme280.hpp
+ * @brief C++17 BME280 driver with the configuration fixed at compile time
+ *
+ * The sensor settings are template parameters of bme280::Config. Register
+ * bytes, the datasheet measurement time, the output period and the burst
+ * read window are constants computed from them, and settings that cannot
+ * work together fail to compile. bme280::Device::read() is one burst read
+ * of exactly the enabled channels followed by the compensation; which
+ * channels to compensate is decided with if constexpr, not at run time.
+ *
+ *   using Env = bme280::Config<SAMPLING_X2, SAMPLING_X16, SAMPLING_X1,
+ *                              FILTER_X16, STANDBY_MS_62_5>;
+ *   bme280::Device<Env> env(BME280_ADDRESS_ALTERNATE);
+ *   env.begin();
+ *   env.read(sample);
+ *
+ * Each Device keeps its own address, transport and calibration, so it does
+ * not share the per-thread state of the C driver. Compensation uses the
+ * same C routines.
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef BME280_HPP
+#define BME280_HPP
+
+#if __cplusplus < 201703L
+#error "bme280.hpp requires C++17"
+#endif
+
+#include "bme280.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+namespace coreflight::bme280 {
+
+/**
+ * @brief Chip the configuration targets
+ */
+enum class Chip : uint8_t {
+  BME280 = BME280_CHIP_ID, /**< Temperature, pressure and humidity */
+  BMP280 = BMP280_CHIP_ID  /**< Temperature and pressure only */
+};
+
+/**
+ * @brief ctrl_hum register (0xF2)
+ */
+struct CtrlHum {
+  sensor_sampling osrs_h; /**< Humidity oversampling */
+
+  constexpr uint8_t value() const { return static_cast<uint8_t>(osrs_h); }
+};
+
+/**
+ * @brief ctrl_meas register (0xF4)
+ */
+struct CtrlMeas {
+  sensor_sampling osrs_t; /**< Temperature oversampling */
+  sensor_sampling osrs_p; /**< Pressure oversampling */
+  sensor_mode mode;       /**< Device mode */
+
+  constexpr uint8_t value() const {
+    return static_cast<uint8_t>(osrs_t << 5 | osrs_p << 2 | mode);
+  }
+};
+
+/**
+ * @brief config register (0xF5)
+ */
+struct ConfigReg {
+  standby_duration t_sb; /**< Standby time in normal mode */
+  sensor_filter filter;  /**< IIR filter coefficient */
+  bool spi3w_en;         /**< SPI 3-wire enable */
+
+  constexpr uint8_t value() const {
+    return static_cast<uint8_t>(t_sb << 5 | filter << 2 | (spi3w_en ? 1 : 0));
+  }
+};
+
+/**
+ * @brief Oversampling count of a setting
+ */
+constexpr uint32_t oversamples(sensor_sampling s) {
+  return s == SAMPLING_NONE ? 0 : 1u << (s - SAMPLING_X1);
+}
+
+/**
+ * @brief Standby time of a setting in microseconds
+ */
+constexpr uint32_t standby_us(standby_duration t) {
+  switch (t) {
+  case STANDBY_MS_0_5:
+    return 500;
+  case STANDBY_MS_10:
+    return 10000;
+  case STANDBY_MS_20:
+    return 20000;
+  case STANDBY_MS_62_5:
+    return 62500;
+  case STANDBY_MS_125:
+    return 125000;
+  case STANDBY_MS_250:
+    return 250000;
+  case STANDBY_MS_500:
+    return 500000;
+  case STANDBY_MS_1000:
+    return 1000000;
+  }
+  return 0;
+}
+
+/**
+ * @brief Compile-time sensor configuration
+ * @tparam OsrsT Temperature oversampling
+ * @tparam OsrsP Pressure oversampling, SAMPLING_NONE to skip
+ * @tparam OsrsH Humidity oversampling, SAMPLING_NONE to skip
+ * @tparam Filter IIR filter coefficient
+ * @tparam Standby Standby time between conversions in normal mode
+ * @tparam Mode MODE_NORMAL or MODE_FORCED
+ * @tparam Device Chip the configuration is meant for
+ */
+template <sensor_sampling OsrsT, sensor_sampling OsrsP, sensor_sampling OsrsH,
+          sensor_filter Filter = FILTER_OFF,
+          standby_duration Standby = STANDBY_MS_0_5,
+          sensor_mode Mode = MODE_NORMAL, Chip Device = Chip::BME280>
+struct Config {
+  static_assert(OsrsT <= SAMPLING_X16 && OsrsP <= SAMPLING_X16 &&
+                    OsrsH <= SAMPLING_X16,
+                "oversampling is NONE or X1..X16");
+  static_assert(Filter <= FILTER_X16, "filter is OFF or X2..X16");
+  static_assert(OsrsT != SAMPLING_NONE,
+                "every compensation needs the temperature measurement");
+  static_assert(Device == Chip::BME280 || OsrsH == SAMPLING_NONE,
+                "the BMP280 has no humidity sensor");
+  static_assert(Mode == MODE_NORMAL || Mode == MODE_FORCED,
+                "a sleeping sensor never produces samples");
+  static_assert(Mode == MODE_NORMAL || Standby == STANDBY_MS_0_5,
+                "the standby time only applies in normal mode");
+
+  static constexpr Chip chip = Device;
+  static constexpr bool has_pressure = OsrsP != SAMPLING_NONE;
+  static constexpr bool has_humidity = OsrsH != SAMPLING_NONE;
+
+  static constexpr CtrlHum ctrl_hum{OsrsH};
+  static constexpr CtrlMeas ctrl_meas{OsrsT, OsrsP, Mode};
+  static constexpr ConfigReg config{Standby, Filter, false};
+
+  /** @brief Worst-case conversion time, datasheet section 9.1 (µs) */
+  static constexpr uint32_t measure_time_us =
+      1250 + 2300 * oversamples(OsrsT) +
+      (has_pressure ? 2300 * oversamples(OsrsP) + 575 : 0) +
+      (has_humidity ? 2300 * oversamples(OsrsH) + 575 : 0);
+
+  /** @brief Time between fresh samples in normal mode (µs) */
+  static constexpr uint32_t period_us =
+      Mode == MODE_NORMAL ? measure_time_us + standby_us(Standby)
+                          : measure_time_us;
+
+  /** @brief First data register of the burst: pressure, else temperature */
+  static constexpr uint8_t burst_first =
+      has_pressure ? BME280_REGISTER_PRESSUREDATA : BME280_REGISTER_TEMPDATA;
+
+  /** @brief Burst length, stops after temperature if humidity is off */
+  static constexpr uint8_t burst_length =
+      (has_humidity ? BME280_REGISTER_HUMIDDATA + 2
+                    : BME280_REGISTER_HUMIDDATA) -
+      burst_first;
+};
+
+/**
+ * @brief BME280/BMP280 bound to one address and transport
+ * @tparam Cfg Instance of bme280::Config
+ */
+template <class Cfg> class Device {
+public:
+  using config = Cfg;
+
+  /**
+   * @param address I2C address (0x76 or 0x77), ignored on SPI
+   * @param bus Transport, nullptr for the default I2C backend
+   */
+  explicit Device(uint8_t address = BME280_ADDRESS_ALTERNATE,
+                  const i2c_tools_backend_t *bus = nullptr)
+      : address_(address), bus_(bus) {}
+
+  /**
+   * @brief Reset, load the calibration and write the configuration
+   *
+   * Does not wait for the first conversion, see ready_ns().
+   *
+   * @return 0 on success, negative value on error
+   */
+  int begin() {
+    i2c_tools_use(bus_);
+    int ret = i2c_tools_init();
+    if (ret != BCM2835_I2C_REASON_OK) {
+      fprintf(stderr, "Error initializing I2C: %d\n", ret);
+      return ret;
+    }
+    i2c_tools_select(bus_, address_);
+    uint8_t chip_id = i2c_tool_read_byte(BME280_REGISTER_CHIPID);
+    if (chip_id != static_cast<uint8_t>(Cfg::chip)) {
+      fprintf(stderr, "Error BME280 chip ID 0x%02X, expected 0x%02X\n",
+              chip_id, static_cast<uint8_t>(Cfg::chip));
+      return -1;
+    }
+
+    ret = i2c_tool_write_reg(BME280_REGISTER_SOFTRESET, 0xB6);
+    if (ret != 0) {
+      return ret;
+    }
+    i2c_tools_delay_us(BME280_STARTUP_US);
+    for (uint32_t waited = 0;
+         i2c_tool_read_byte(BME280_REGISTER_STATUS) & 0x01;
+         waited += BME280_NVM_POLL_US) {
+      if (waited >= BME280_NVM_TIMEOUT_US) {
+        fprintf(stderr, "Error BME280 NVM copy did not finish\n");
+        return -2;
+      }
+      i2c_tools_delay_us(BME280_NVM_POLL_US);
+    }
+
+    char tp[BME280_CALIB_TP_SIZE];
+    char h[BME280_CALIB_H_SIZE];
+    if (i2c_tools_read_reg(BME280_REGISTER_DIG_T1, tp, sizeof(tp)) != 0 ||
+        i2c_tools_read_reg(BME280_REGISTER_DIG_H2, h, sizeof(h)) != 0) {
+      return -3;
+    }
+    bme280_parse_calibration(reinterpret_cast<const uint8_t *>(tp),
+                             reinterpret_cast<const uint8_t *>(h), &calib_);
+
+    // ctrl_hum only takes effect with the following ctrl_meas write
+    i2c_tool_write_reg(BME280_REGISTER_CONTROL, MODE_SLEEP);
+    i2c_tool_write_reg(BME280_REGISTER_CONTROLHUMID, Cfg::ctrl_hum.value());
+    i2c_tool_write_reg(BME280_REGISTER_CONFIG, Cfg::config.value());
+    i2c_tool_write_reg(BME280_REGISTER_CONTROL, Cfg::ctrl_meas.value());
+    ready_ns_ = i2c_tools_timestamp_ns() + Cfg::measure_time_us * 1000ULL;
+    return 0;
+  }
+
+  /**
+   * @brief Time the first conversion is complete (monotonic ns)
+   */
+  uint64_t ready_ns() const { return ready_ns_; }
+
+  /**
+   * @brief Start a conversion, forced mode only
+   * @return 0 on success, negative value on error
+   */
+  int trigger() {
+    static_assert(Cfg::ctrl_meas.mode == MODE_FORCED,
+                  "only forced mode needs a trigger");
+    i2c_tools_select(bus_, address_);
+    return i2c_tool_write_reg(BME280_REGISTER_CONTROL, Cfg::ctrl_meas.value());
+  }
+
+  /**
+   * @brief Read and compensate the configured channels in one burst
+   * @param sample Destination, disabled channels are set to 0
+   * @return 0 on success, negative value on error
+   */
+  int read(bme280_sample_t &sample) {
+    i2c_tools_select(bus_, address_);
+    char buffer[Cfg::burst_length];
+    int ret = i2c_tools_read_reg(Cfg::burst_first, buffer, Cfg::burst_length);
+    if (ret != 0) {
+      return ret;
+    }
+    sample.timestamp_ns = i2c_tools_last_timestamp_ns();
+
+    const uint8_t *data = reinterpret_cast<const uint8_t *>(buffer);
+    constexpr size_t t = Cfg::has_pressure ? 3 : 0;
+    int32_t t_fine =
+        bme280_calc_t_fine(&calib_, unpack20(&data[t]));
+    sample.temperature = bme280_calc_temperature(t_fine);
+
+    if constexpr (Cfg::has_pressure) {
+      sample.pressure = bme280_calc_pressure(&calib_, t_fine, unpack20(data));
+    } else {
+      sample.pressure = 0;
+    }
+    if constexpr (Cfg::has_humidity) {
+      int32_t adc_H = static_cast<int32_t>(data[t + 3]) << 8 | data[t + 4];
+      sample.humidity = bme280_calc_humidity(&calib_, t_fine, adc_H);
+    } else {
+      sample.humidity = 0;
+    }
+    return 0;
+  }
+
+  /**
+   * @brief Calibration loaded by begin()
+   */
+  const bme280_calib_data_t &calibration() const { return calib_; }
+
+private:
+  static int32_t unpack20(const uint8_t *p) {
+    return static_cast<int32_t>(p[0]) << 12 | static_cast<int32_t>(p[1]) << 4 |
+           p[2] >> 4;
+  }
+
+  uint8_t address_;
+  const i2c_tools_backend_t *bus_;
+  bme280_calib_data_t calib_{};
+  uint64_t ready_ns_ = 0;
+};
+
+} // namespace coreflight::bme280
+
+#endif // BME280_HPP
@@ -0,0 +1,229 @@
+/**
+ * @file mpu6050.hpp
+ * @brief C++17 MPU6050 driver with the configuration fixed at compile time
+ *
+ * Full-scale ranges, the digital low-pass filter and the sample rate
+ * divider are template parameters of mpu6050::Config. The register bytes,
+ * the sensitivities and the output data rate are constants, so
+ * mpu6050::Device::read() is one 14-byte burst (accelerometer, temperature,
+ * gyroscope) and a division per axis by a constant sensitivity, with none
+ * of the register reads the C driver does to find the current range. The
+ * results are the same bits mpu6050_get_acce/gyro return.
+ * mpu6050::FifoBudget sizes FIFO drain buffers for a polling period and
+ * rejects periods that would let the FIFO overflow.
+ *
+ *   using Imu = mpu6050::Config<MPU6050_RANGE_4_G, MPU6050_RANGE_500_DEG,
+ *                               MPU6050_BAND_44_HZ, 9>;
+ *   mpu6050::Device<Imu> imu;
+ *   imu.begin();
+ *   imu.read(acce, gyro);
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef MPU6050_HPP
+#define MPU6050_HPP
+
+#if __cplusplus < 201703L
+#error "mpu6050.hpp requires C++17"
+#endif
+
+#include "mpu6050.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+namespace coreflight::mpu6050 {
+
+/**
+ * @brief Accelerometer sensitivity of a range (LSB/g)
+ */
+constexpr float acce_sensitivity(mpu6050_accel_range_t range) {
+  return 16384.0f / static_cast<float>(1 << range);
+}
+
+/**
+ * @brief Gyroscope sensitivity of a range (LSB/(deg/s)), per the datasheet
+ */
+constexpr float gyro_sensitivity(mpu6050_gyro_range_t range) {
+  switch (range) {
+  case MPU6050_RANGE_250_DEG:
+    return 131.0f;
+  case MPU6050_RANGE_500_DEG:
+    return 65.5f;
+  case MPU6050_RANGE_1000_DEG:
+    return 32.8f;
+  case MPU6050_RANGE_2000_DEG:
+    return 16.4f;
+  }
+  return 0.0f;
+}
+
+/**
+ * @brief Compile-time sensor configuration
+ * @tparam Accel Accelerometer full-scale range
+ * @tparam Gyro Gyroscope full-scale range
+ * @tparam Dlpf Digital low-pass filter bandwidth
+ * @tparam SampleDiv Sample rate divider (SMPLRT_DIV)
+ */
+template <mpu6050_accel_range_t Accel, mpu6050_gyro_range_t Gyro,
+          mpu6050_bandwidth_t Dlpf = MPU6050_BAND_44_HZ,
+          uint8_t SampleDiv = 0>
+struct Config {
+  static_assert(Accel <= MPU6050_RANGE_16_G, "invalid accelerometer range");
+  static_assert(Gyro <= MPU6050_RANGE_2000_DEG, "invalid gyroscope range");
+  static_assert(Dlpf <= MPU6050_BAND_5_HZ, "invalid filter bandwidth");
+
+  static constexpr uint8_t smplrt_div = SampleDiv;
+  static constexpr uint8_t config = static_cast<uint8_t>(Dlpf);
+  static constexpr uint8_t gyro_config = static_cast<uint8_t>(Gyro << 3);
+  static constexpr uint8_t accel_config = static_cast<uint8_t>(Accel << 3);
+
+  /** @brief Divisors of the raw readings, the values the C driver uses */
+  static constexpr float acce_lsb = acce_sensitivity(Accel);
+  static constexpr float gyro_lsb = gyro_sensitivity(Gyro);
+
+  /** @brief Gyroscope output rate before the divider, 8 kHz unfiltered */
+  static constexpr uint32_t gyro_rate_hz =
+      Dlpf == MPU6050_BAND_260_HZ ? 8000 : 1000;
+
+  /** @brief Output data rate (Hz) */
+  static constexpr float sample_rate_hz =
+      static_cast<float>(gyro_rate_hz) / (1.0f + SampleDiv);
+
+  /** @brief Output data period (ns) */
+  static constexpr uint64_t sample_period_ns =
+      1000000000ULL * (1 + SampleDiv) / gyro_rate_hz;
+
+  static_assert(gyro_rate_hz / (1 + SampleDiv) <= 1000,
+                "the accelerometer updates at 1 kHz; faster sample rates "
+                "repeat its samples, raise SampleDiv or enable the DLPF");
+};
+
+/**
+ * @brief FIFO buffer sizing for a fixed polling period
+ * @tparam Cfg Instance of mpu6050::Config
+ * @tparam PollPeriodUs Time between FIFO drains (µs)
+ */
+template <class Cfg, uint32_t PollPeriodUs> struct FifoBudget {
+  /** @brief Most frames that can accumulate between two drains */
+  static constexpr size_t frames =
+      (PollPeriodUs * 1000ULL + Cfg::sample_period_ns - 1) /
+          Cfg::sample_period_ns +
+      1;
+
+  /** @brief Bytes of the drain buffer */
+  static constexpr size_t bytes = frames * MPU6050_FIFO_FRAME_SIZE;
+
+  static_assert(bytes < MPU6050_FIFO_SIZE,
+                "the FIFO overflows between drains, poll more often");
+};
+
+/**
+ * @brief MPU6050 bound to one address and transport
+ * @tparam Cfg Instance of mpu6050::Config
+ */
+template <class Cfg> class Device {
+public:
+  using config = Cfg;
+
+  /**
+   * @param address I2C address (0x68 or 0x69)
+   * @param bus Transport, nullptr for the default I2C backend
+   */
+  explicit Device(uint8_t address = MPU6050_ADDRESS,
+                  const i2c_tools_backend_t *bus = nullptr)
+      : address_(address), bus_(bus) {}
+
+  /**
+   * @brief Wake the sensor and write the configuration
+   *
+   * Does not wait for the gyroscope to settle, see ready_ns().
+   *
+   * @return 0 on success, negative value on error
+   */
+  int begin() {
+    i2c_tools_use(bus_);
+    int ret = i2c_tools_init();
+    if (ret != BCM2835_I2C_REASON_OK) {
+      fprintf(stderr, "Error initializing I2C: %d\n", ret);
+      return ret;
+    }
+    i2c_tools_select(bus_, address_);
+    uint8_t chip_id = i2c_tool_read_byte(MPU6050_WHO_AM_I);
+    if (chip_id != MPU6050_CHIP_ID) {
+      fprintf(stderr, "Error MPU6050 WHO_AM_I 0x%02X, expected 0x%02X\n",
+              chip_id, MPU6050_CHIP_ID);
+      return -1;
+    }
+
+    // Clears SLEEP and keeps the internal oscillator, as the C driver does
+    if (i2c_tool_write_reg(MPU6050_PWR_MGMT_1, 0x00) != 0 ||
+        i2c_tool_write_reg(MPU6050_SMPLRT_DIV, Cfg::smplrt_div) != 0 ||
+        i2c_tool_write_reg(MPU6050_CONFIG, Cfg::config) != 0 ||
+        i2c_tool_write_reg(MPU6050_GYRO_CONFIG, Cfg::gyro_config) != 0 ||
+        i2c_tool_write_reg(MPU6050_ACCEL_CONFIG, Cfg::accel_config) != 0) {
+      return -3;
+    }
+    ready_ns_ = i2c_tools_timestamp_ns() + MPU6050_STARTUP_US * 1000ULL;
+    return 0;
+  }
+
+  /**
+   * @brief Time the gyroscope has settled (monotonic ns)
+   */
+  uint64_t ready_ns() const { return ready_ns_; }
+
+  /**
+   * @brief Raw offsets subtracted before scaling (LSB)
+   */
+  void set_bias(const int16_t acce[3], const int16_t gyro[3]) {
+    for (int axis = 0; axis < 3; axis++) {
+      bias_[axis] = acce[axis];
+      bias_[axis + 3] = gyro[axis];
+    }
+  }
+
+  /**
+   * @brief Read both sensors in one burst and convert them
+   * @param acce Acceleration in g
+   * @param gyro Angular rate in deg/s
+   * @return 0 on success, negative value on error
+   */
+  int read(mpu6050_acce_value_t &acce, mpu6050_gyro_value_t &gyro) {
+    i2c_tools_select(bus_, address_);
+    char buffer[14];
+    int ret = i2c_tools_read_reg(MPU6050_ACCEL_XOUT_H, buffer, sizeof(buffer));
+    if (ret != 0) {
+      return ret;
+    }
+    const uint8_t *d = reinterpret_cast<const uint8_t *>(buffer);
+    acce.timestamp_ns = gyro.timestamp_ns = i2c_tools_last_timestamp_ns();
+    // Bytes 6 and 7 are the temperature
+    acce.acce_x = axis(d, 0, Cfg::acce_lsb);
+    acce.acce_y = axis(d, 1, Cfg::acce_lsb);
+    acce.acce_z = axis(d, 2, Cfg::acce_lsb);
+    gyro.gyro_x = axis(d + 2, 3, Cfg::gyro_lsb);
+    gyro.gyro_y = axis(d + 2, 4, Cfg::gyro_lsb);
+    gyro.gyro_z = axis(d + 2, 5, Cfg::gyro_lsb);
+    return 0;
+  }
+
+private:
+  // Divide, as mpu6050_get_acce/gyro do, so both give the same bits
+  float axis(const uint8_t *d, int index, float sensitivity) const {
+    int16_t raw = static_cast<int16_t>(d[2 * index] << 8 | d[2 * index + 1]);
+    return static_cast<float>(raw - bias_[index]) / sensitivity;
+  }
+
+  uint8_t address_;
+  const i2c_tools_backend_t *bus_;
+  int16_t bias_[6] = {0, 0, 0, 0, 0, 0};
+  uint64_t ready_ns_ = 0;
+};
+
+} // namespace coreflight::mpu6050
+
+#endif // MPU6050_HPP
@@ -0,0 +1,143 @@
+/**
+ * @file i2c_replay.h
+ * @brief Bus transaction recorder and deterministic replay backend
+ *
+ * The recorder wraps the active i2c_tools backend and logs every
+ * transaction (slave address, register, bytes, result and timestamp) to a
+ * compact file. The replay backend serves those exact bytes and timestamps
+ * back to the drivers, either as fast as possible or paced at the original
+ * timing, so a field capture can be rerun off-target through the unchanged
+ * bme280_* / mpu6050_* code.
+ *
+ * A request that does not match the next record is a divergence. The
+ * replay then resynchronises on the next matching record a short way
+ * ahead, so a run past the first divergence still follows the capture;
+ * i2c_replay_t::divergences counts both the mismatched requests and the
+ * records skipped. A diverging init returns an error, as a failing bus
+ * would.
+ *
+ * File layout: an 8-byte header (magic, version) followed by records of
+ *   op (1 byte), argument (1 byte), timestamp delta (varint, ns),
+ *   then per op: READ length, result, data; WRITE data, result;
+ *   INIT result; BAUD rate (4 bytes, little endian).
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef I2C_REPLAY_H
+#define I2C_REPLAY_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "i2c_tools.h"
+#include <stddef.h>
+#include <stdio.h>
+
+/** @brief Capture file magic ("I2CR") */
+#define I2C_REPLAY_MAGIC (0x52433249UL)
+
+/** @brief Capture file format version */
+#define I2C_REPLAY_VERSION (1)
+
+/**
+ * @brief Recorded operations
+ */
+typedef enum {
+  I2C_REPLAY_OP_INIT = 1,    /**< i2c_tools_init */
+  I2C_REPLAY_OP_SLAVE = 2,   /**< Slave address change */
+  I2C_REPLAY_OP_BAUD = 3,    /**< i2c_tools_set_baudrate */
+  I2C_REPLAY_OP_READ = 4,    /**< i2c_tools_read_reg */
+  I2C_REPLAY_OP_WRITE = 5,   /**< i2c_tool_write_reg */
+  I2C_REPLAY_OP_CLEANUP = 6  /**< i2c_tool_cleanup */
+} i2c_replay_op_t;
+
+/**
+ * @brief Replay pacing
+ */
+typedef enum {
+  I2C_REPLAY_FAST = 0,    /**< Serve transactions as fast as requested */
+  I2C_REPLAY_REALTIME = 1 /**< Hold each transaction until its original time */
+} i2c_replay_mode_t;
+
+/**
+ * @brief Recorder state
+ */
+typedef struct {
+  FILE *file;                       /**< Capture file */
+  const i2c_tools_backend_t *inner; /**< Backend doing the real transfers */
+  i2c_tools_backend_t backend;      /**< Recording backend */
+  uint64_t last_ns;                 /**< Time of the previous record */
+  int slave;                        /**< Last recorded address, -1 if none */
+  uint64_t transactions;            /**< Records written */
+} i2c_recorder_t;
+
+/**
+ * @brief Replay state
+ */
+typedef struct {
+  uint8_t *data;                       /**< Whole capture in memory */
+  size_t size;                         /**< Capture size */
+  size_t pos;                          /**< Next record */
+  i2c_replay_mode_t mode;              /**< Pacing */
+  i2c_tools_backend_t backend;         /**< Replay backend */
+  const i2c_tools_backend_t *previous; /**< Backend to restore on stop */
+  uint64_t clock_ns;                   /**< Recorded time of the last record */
+  uint64_t first_ns;                   /**< Recorded time of the first read */
+  uint64_t wall_start_ns;              /**< Host time of the first read */
+  int recorded_slave;                  /**< Address in effect in the capture */
+  int slave;                           /**< Address requested by the driver */
+  uint64_t transactions;               /**< Reads and writes served */
+  uint64_t divergences;                /**< Mismatched or skipped records */
+} i2c_replay_t;
+
+/**
+ * @brief Start recording the active backend and install the recorder
+ * @param rec Recorder state
+ * @param path Capture file to create
+ * @return 0 on success, negative value on error
+ */
+int i2c_recorder_start(i2c_recorder_t *rec, const char *path);
+
+/**
+ * @brief Stop recording, restore the wrapped backend and close the file
+ * @param rec Recorder state
+ * @return 0 on success, negative value if the capture could not be flushed
+ */
+int i2c_recorder_stop(i2c_recorder_t *rec);
+
+/**
+ * @brief Load a capture and install the replay backend
+ * @param replay Replay state
+ * @param path Capture file
+ * @param mode Pacing
+ * @return 0 on success, negative value on error
+ */
+int i2c_replay_start(i2c_replay_t *replay, const char *path,
+                     i2c_replay_mode_t mode);
+
+/**
+ * @brief Restart the capture from its first record
+ * @param replay Replay state
+ */
+void i2c_replay_rewind(i2c_replay_t *replay);
+
+/**
+ * @brief Check whether every record has been served
+ * @param replay Replay state
+ * @return Non-zero at the end of the capture
+ */
+int i2c_replay_finished(const i2c_replay_t *replay);
+
+/**
+ * @brief Restore the previous backend and release the capture
+ * @param replay Replay state
+ */
+void i2c_replay_stop(i2c_replay_t *replay);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // I2C_REPLAY_H
@@ -0,0 +1,484 @@
+/**
+ * @file i2c_replay.c
+ * @brief Implementation of the bus recorder and replay backend
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <i2c_replay.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/** @brief Bytes of the capture file header */
+#define I2C_REPLAY_HEADER_SIZE (8)
+
+/** @brief Records searched ahead to resynchronise after a divergence */
+#define I2C_REPLAY_RESYNC_RECORDS (64)
+
+static uint64_t i2c_replay_monotonic_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Recorder                                                                 */
+/* ------------------------------------------------------------------------ */
+
+static uint64_t i2c_recorder_now(const i2c_recorder_t *rec) {
+  if (rec->inner->timestamp_ns != NULL) {
+    return rec->inner->timestamp_ns(rec->inner->ctx);
+  }
+  return i2c_replay_monotonic_ns();
+}
+
+/**
+ * @brief Write the common record prefix: op, argument, timestamp delta
+ */
+static void i2c_recorder_begin(i2c_recorder_t *rec, i2c_replay_op_t op,
+                               uint8_t arg, uint64_t timestamp_ns) {
+  uint8_t prefix[12];
+  size_t length = 0;
+  prefix[length++] = (uint8_t)op;
+  prefix[length++] = arg;
+
+  // Unsigned wrap keeps the delta exact even if a timestamp goes backwards
+  uint64_t delta = timestamp_ns - rec->last_ns;
+  while (delta >= 0x80) {
+    prefix[length++] = (uint8_t)(delta | 0x80);
+    delta >>= 7;
+  }
+  prefix[length++] = (uint8_t)delta;
+  fwrite(prefix, 1, length, rec->file);
+  rec->last_ns = timestamp_ns;
+  rec->transactions++;
+}
+
+static int i2c_recorder_init(void *ctx) {
+  i2c_recorder_t *rec = (i2c_recorder_t *)ctx;
+  int ret = rec->inner->init(rec->inner->ctx);
+  i2c_recorder_begin(rec, I2C_REPLAY_OP_INIT, 0, i2c_recorder_now(rec));
+  fputc((int8_t)(ret < 0 ? ret : 0), rec->file);
+  return ret;
+}
+
+static int i2c_recorder_set_slave_address(void *ctx, uint8_t slave_addr) {
+  i2c_recorder_t *rec = (i2c_recorder_t *)ctx;
+  int ret = rec->inner->set_slave_address(rec->inner->ctx, slave_addr);
+  // Drivers reselect on every call, only changes are worth recording
+  if (rec->slave != slave_addr) {
+    i2c_recorder_begin(rec, I2C_REPLAY_OP_SLAVE, slave_addr,
+                       i2c_recorder_now(rec));
+    rec->slave = slave_addr;
+  }
+  return ret;
+}
+
+static void i2c_recorder_set_baudrate(void *ctx, uint32_t baudrate) {
+  i2c_recorder_t *rec = (i2c_recorder_t *)ctx;
+  rec->inner->set_baudrate(rec->inner->ctx, baudrate);
+  i2c_recorder_begin(rec, I2C_REPLAY_OP_BAUD, 0, i2c_recorder_now(rec));
+  for (int i = 0; i < 4; i++) {
+    fputc((int)((baudrate >> (8 * i)) & 0xFF), rec->file);
+  }
+}
+
+static int i2c_recorder_read_reg(void *ctx, uint8_t reg_address, char *buffer,
+                                 uint8_t length, uint64_t *timestamp_ns) {
+  i2c_recorder_t *rec = (i2c_recorder_t *)ctx;
+  *timestamp_ns = 0;
+  int ret = rec->inner->read_reg(rec->inner->ctx, reg_address, buffer, length,
+                                 timestamp_ns);
+  if (*timestamp_ns == 0) {
+    *timestamp_ns = i2c_recorder_now(rec);
+  }
+  i2c_recorder_begin(rec, I2C_REPLAY_OP_READ, reg_address, *timestamp_ns);
+  fputc(length, rec->file);
+  fputc((int8_t)ret, rec->file);
+  fwrite(buffer, 1, length, rec->file);
+  return ret;
+}
+
+static int i2c_recorder_write_reg(void *ctx, uint8_t reg_address,
+                                  uint8_t data) {
+  i2c_recorder_t *rec = (i2c_recorder_t *)ctx;
+  int ret = rec->inner->write_reg(rec->inner->ctx, reg_address, data);
+  i2c_recorder_begin(rec, I2C_REPLAY_OP_WRITE, reg_address,
+                     i2c_recorder_now(rec));
+  fputc(data, rec->file);
+  fputc((int8_t)ret, rec->file);
+  return ret;
+}
+
+static void i2c_recorder_cleanup(void *ctx) {
+  i2c_recorder_t *rec = (i2c_recorder_t *)ctx;
+  rec->inner->cleanup(rec->inner->ctx);
+  i2c_recorder_begin(rec, I2C_REPLAY_OP_CLEANUP, 0, i2c_recorder_now(rec));
+  fflush(rec->file);
+}
+
+static uint64_t i2c_recorder_timestamp_ns(void *ctx) {
+  return i2c_recorder_now((const i2c_recorder_t *)ctx);
+}
+
+static void i2c_recorder_delay_us(void *ctx, uint32_t micros) {
+  i2c_recorder_t *rec = (i2c_recorder_t *)ctx;
+  if (rec->inner->delay_us != NULL) {
+    rec->inner->delay_us(rec->inner->ctx, micros);
+  } else {
+    bcm2835_delayMicroseconds(micros);
+  }
+}
+
+int i2c_recorder_start(i2c_recorder_t *rec, const char *path) {
+  memset(rec, 0, sizeof(*rec));
+  rec->file = fopen(path, "wb");
+  if (rec->file == NULL) {
+    fprintf(stderr, "Error creating bus capture %s\n", path);
+    return -1;
+  }
+
+  uint8_t header[I2C_REPLAY_HEADER_SIZE] = {0};
+  for (int i = 0; i < 4; i++) {
+    header[i] = (uint8_t)(I2C_REPLAY_MAGIC >> (8 * i));
+  }
+  header[4] = (uint8_t)I2C_REPLAY_VERSION;
+  header[5] = (uint8_t)(I2C_REPLAY_VERSION >> 8);
+  fwrite(header, 1, sizeof(header), rec->file);
+
+  rec->inner = i2c_tools_get_backend();
+  rec->slave = -1;
+  rec->backend.init = i2c_recorder_init;
+  rec->backend.set_slave_address = i2c_recorder_set_slave_address;
+  rec->backend.set_baudrate = i2c_recorder_set_baudrate;
+  rec->backend.read_reg = i2c_recorder_read_reg;
+  rec->backend.write_reg = i2c_recorder_write_reg;
+  rec->backend.cleanup = i2c_recorder_cleanup;
+  rec->backend.timestamp_ns = i2c_recorder_timestamp_ns;
+  rec->backend.delay_us = i2c_recorder_delay_us;
+  rec->backend.ctx = rec;
+  i2c_tools_set_backend(&rec->backend);
+  return 0;
+}
+
+int i2c_recorder_stop(i2c_recorder_t *rec) {
+  if (i2c_tools_get_backend() == &rec->backend) {
+    i2c_tools_set_backend(rec->inner);
+  }
+  int ret = fclose(rec->file) == 0 ? 0 : -1;
+  rec->file = NULL;
+  return ret;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Replay                                                                   */
+/* ------------------------------------------------------------------------ */
+
+/**
+ * @brief Decoded view of one capture record
+ */
+typedef struct {
+  i2c_replay_op_t op;   /**< Operation */
+  uint8_t arg;          /**< Register or slave address */
+  uint64_t timestamp_ns; /**< Absolute recorded time */
+  const uint8_t *body;  /**< Operation specific payload */
+  size_t next;          /**< Offset of the following record */
+} i2c_replay_record_t;
+
+/**
+ * @return 1 if a complete record was decoded at pos, 0 otherwise
+ */
+static int i2c_replay_peek(const i2c_replay_t *replay, size_t pos,
+                           i2c_replay_record_t *record) {
+  const uint8_t *data = replay->data;
+  size_t size = replay->size;
+  if (pos + 3 > size) {
+    return 0;
+  }
+  record->op = (i2c_replay_op_t)data[pos];
+  record->arg = data[pos + 1];
+  pos += 2;
+
+  uint64_t delta = 0;
+  for (int shift = 0;; shift += 7) {
+    if (pos >= size || shift > 63) {
+      return 0;
+    }
+    uint8_t byte = data[pos++];
+    delta |= (uint64_t)(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) {
+      break;
+    }
+  }
+  record->timestamp_ns = replay->clock_ns + delta;
+  record->body = &data[pos];
+
+  size_t body = 0;
+  switch (record->op) {
+  case I2C_REPLAY_OP_INIT:
+    body = 1;
+    break;
+  case I2C_REPLAY_OP_BAUD:
+    body = 4;
+    break;
+  case I2C_REPLAY_OP_READ:
+    body = pos + 2 <= size ? 2 + (size_t)data[pos] : 2;
+    break;
+  case I2C_REPLAY_OP_WRITE:
+    body = 2;
+    break;
+  case I2C_REPLAY_OP_SLAVE:
+  case I2C_REPLAY_OP_CLEANUP:
+    break;
+  default:
+    return 0;
+  }
+  if (pos + body > size) {
+    return 0;
+  }
+  record->next = pos + body;
+  return 1;
+}
+
+static void i2c_replay_consume(i2c_replay_t *replay,
+                               const i2c_replay_record_t *record) {
+  replay->pos = record->next;
+  replay->clock_ns = record->timestamp_ns;
+  if (record->op == I2C_REPLAY_OP_SLAVE) {
+    replay->recorded_slave = record->arg;
+  }
+}
+
+/**
+ * @brief Whether a record serves the request (length < 0 matches any)
+ */
+static int i2c_replay_matches(const i2c_replay_t *replay,
+                              const i2c_replay_record_t *record,
+                              i2c_replay_op_t op, uint8_t arg, int length) {
+  if (record->op != op || record->arg != arg) {
+    return 0;
+  }
+  if (op != I2C_REPLAY_OP_READ && op != I2C_REPLAY_OP_WRITE) {
+    return 1;
+  }
+  return replay->recorded_slave == replay->slave &&
+         (length < 0 || record->body[0] == length);
+}
+
+/**
+ * @brief Find the next record of a given op, applying address changes
+ *
+ * If the next record does not match, up to I2C_REPLAY_RESYNC_RECORDS
+ * records ahead are searched and the replay resumes at the first match,
+ * each record skipped counting as a divergence. Without a match the
+ * position is left alone and the request counts as one divergence, so a
+ * driver that issues an extra transaction does not lose the capture.
+ *
+ * @return 1 if a matching record was found, 0 on divergence
+ */
+static int i2c_replay_expect(i2c_replay_t *replay, i2c_replay_op_t op,
+                             uint8_t arg, int length,
+                             i2c_replay_record_t *record) {
+  size_t pos = replay->pos;
+  uint64_t clock_ns = replay->clock_ns;
+  int recorded_slave = replay->recorded_slave;
+  uint64_t skipped = 0;
+
+  while (skipped <= I2C_REPLAY_RESYNC_RECORDS &&
+         i2c_replay_peek(replay, replay->pos, record)) {
+    if (record->op == I2C_REPLAY_OP_SLAVE ||
+        (record->op == I2C_REPLAY_OP_BAUD && op != I2C_REPLAY_OP_BAUD)) {
+      i2c_replay_consume(replay, record);
+      continue;
+    }
+    if (i2c_replay_matches(replay, record, op, arg, length)) {
+      replay->divergences += skipped;
+      return 1;
+    }
+    i2c_replay_consume(replay, record);
+    skipped++;
+  }
+
+  replay->pos = pos;
+  replay->clock_ns = clock_ns;
+  replay->recorded_slave = recorded_slave;
+  replay->divergences++;
+  return 0;
+}
+
+/**
+ * @brief In real-time mode, hold the caller until the recorded time
+ */
+static void i2c_replay_pace(i2c_replay_t *replay, uint64_t timestamp_ns) {
+  if (replay->wall_start_ns == 0) {
+    replay->wall_start_ns = i2c_replay_monotonic_ns();
+    replay->first_ns = timestamp_ns;
+    return;
+  }
+  if (replay->mode != I2C_REPLAY_REALTIME || timestamp_ns < replay->first_ns) {
+    return;
+  }
+  uint64_t target = replay->wall_start_ns + (timestamp_ns - replay->first_ns);
+  uint64_t now = i2c_replay_monotonic_ns();
+  if (target > now) {
+    uint64_t wait = target - now;
+    struct timespec ts = {(time_t)(wait / 1000000000ULL),
+                          (long)(wait % 1000000000ULL)};
+    nanosleep(&ts, NULL);
+  }
+}
+
+static int i2c_replay_init(void *ctx) {
+  i2c_replay_t *replay = (i2c_replay_t *)ctx;
+  i2c_replay_record_t record;
+  if (!i2c_replay_expect(replay, I2C_REPLAY_OP_INIT, 0, -1, &record)) {
+    return -1;
+  }
+  i2c_replay_consume(replay, &record);
+  return (int8_t)record.body[0];
+}
+
+static int i2c_replay_set_slave_address(void *ctx, uint8_t slave_addr) {
+  i2c_replay_t *replay = (i2c_replay_t *)ctx;
+  replay->slave = slave_addr;
+  return 0;
+}
+
+static void i2c_replay_set_baudrate(void *ctx, uint32_t baudrate) {
+  i2c_replay_t *replay = (i2c_replay_t *)ctx;
+  i2c_replay_record_t record;
+  (void)baudrate;
+  if (i2c_replay_expect(replay, I2C_REPLAY_OP_BAUD, 0, -1, &record)) {
+    i2c_replay_consume(replay, &record);
+  }
+}
+
+static int i2c_replay_read_reg(void *ctx, uint8_t reg_address, char *buffer,
+                               uint8_t length, uint64_t *timestamp_ns) {
+  i2c_replay_t *replay = (i2c_replay_t *)ctx;
+  i2c_replay_record_t record;
+  if (!i2c_replay_expect(replay, I2C_REPLAY_OP_READ, reg_address, length,
+                         &record)) {
+    memset(buffer, 0, length);
+    *timestamp_ns = replay->clock_ns;
+    return -3;
+  }
+  i2c_replay_pace(replay, record.timestamp_ns);
+  i2c_replay_consume(replay, &record);
+  memcpy(buffer, &record.body[2], length);
+  *timestamp_ns = record.timestamp_ns;
+  replay->transactions++;
+  return (int8_t)record.body[1];
+}
+
+static int i2c_replay_write_reg(void *ctx, uint8_t reg_address, uint8_t data) {
+  i2c_replay_t *replay = (i2c_replay_t *)ctx;
+  i2c_replay_record_t record;
+  if (!i2c_replay_expect(replay, I2C_REPLAY_OP_WRITE, reg_address, -1,
+                         &record)) {
+    return -3;
+  }
+  if (record.body[0] != data) {
+    replay->divergences++;
+  }
+  i2c_replay_pace(replay, record.timestamp_ns);
+  i2c_replay_consume(replay, &record);
+  replay->transactions++;
+  return (int8_t)record.body[1];
+}
+
+static void i2c_replay_cleanup(void *ctx) {
+  i2c_replay_t *replay = (i2c_replay_t *)ctx;
+  i2c_replay_record_t record;
+  if (i2c_replay_expect(replay, I2C_REPLAY_OP_CLEANUP, 0, -1, &record)) {
+    i2c_replay_consume(replay, &record);
+  }
+}
+
+static uint64_t i2c_replay_timestamp_ns(void *ctx) {
+  return ((const i2c_replay_t *)ctx)->clock_ns;
+}
+
+static void i2c_replay_delay_us(void *ctx, uint32_t micros) {
+  // Pacing comes from the recorded timestamps, never from driver delays
+  (void)ctx;
+  (void)micros;
+}
+
+int i2c_replay_start(i2c_replay_t *replay, const char *path,
+                     i2c_replay_mode_t mode) {
+  memset(replay, 0, sizeof(*replay));
+  FILE *file = fopen(path, "rb");
+  if (file == NULL) {
+    fprintf(stderr, "Error opening bus capture %s\n", path);
+    return -1;
+  }
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  if (size < I2C_REPLAY_HEADER_SIZE) {
+    fclose(file);
+    return -2;
+  }
+  replay->data = malloc((size_t)size);
+  if (replay->data == NULL ||
+      fread(replay->data, 1, (size_t)size, file) != (size_t)size) {
+    free(replay->data);
+    replay->data = NULL;
+    fclose(file);
+    return -1;
+  }
+  fclose(file);
+
+  uint32_t magic = (uint32_t)replay->data[0] |
+                   ((uint32_t)replay->data[1] << 8) |
+                   ((uint32_t)replay->data[2] << 16) |
+                   ((uint32_t)replay->data[3] << 24);
+  uint16_t version =
+      (uint16_t)(replay->data[4] | ((uint16_t)replay->data[5] << 8));
+  if (magic != I2C_REPLAY_MAGIC || version != I2C_REPLAY_VERSION) {
+    free(replay->data);
+    replay->data = NULL;
+    return -2;
+  }
+
+  replay->size = (size_t)size;
+  replay->mode = mode;
+  i2c_replay_rewind(replay);
+
+  replay->backend.init = i2c_replay_init;
+  replay->backend.set_slave_address = i2c_replay_set_slave_address;
+  replay->backend.set_baudrate = i2c_replay_set_baudrate;
+  replay->backend.read_reg = i2c_replay_read_reg;
+  replay->backend.write_reg = i2c_replay_write_reg;
+  replay->backend.cleanup = i2c_replay_cleanup;
+  replay->backend.timestamp_ns = i2c_replay_timestamp_ns;
+  replay->backend.delay_us = i2c_replay_delay_us;
+  replay->backend.ctx = replay;
+  replay->previous = i2c_tools_get_backend();
+  i2c_tools_set_backend(&replay->backend);
+  return 0;
+}
+
+void i2c_replay_rewind(i2c_replay_t *replay) {
+  replay->pos = I2C_REPLAY_HEADER_SIZE;
+  replay->clock_ns = 0;
+  replay->first_ns = 0;
+  replay->wall_start_ns = 0;
+  replay->recorded_slave = -1;
+}
+
+int i2c_replay_finished(const i2c_replay_t *replay) {
+  return replay->pos >= replay->size;
+}
+
+void i2c_replay_stop(i2c_replay_t *replay) {
+  if (i2c_tools_get_backend() == &replay->backend) {
+    i2c_tools_set_backend(replay->previous);
+  }
+  free(replay->data);
+  replay->data = NULL;
+}
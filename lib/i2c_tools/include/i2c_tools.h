@@ -16,6 +16,78 @@ extern "C" {
 #include "bcm2835.h"
 #include <stdint.h>
 
+/*
+ * Bus state (active backend, slave address, last timestamp) and the driver
+ * state built on top of it are per thread, so one worker thread per bus can
+ * own its bus and its sensors without locks. A thread starts on the bcm2835
+ * backend; backends and driver settings chosen in one thread do not carry
+ * over to another.
+ */
+#ifdef __cplusplus
+#define I2C_TOOLS_THREAD_LOCAL thread_local
+#else
+#define I2C_TOOLS_THREAD_LOCAL _Thread_local
+#endif
+
+/*
+ * Bus backend. Every i2c_tools_* call goes through the active backend; the
+ * default one drives the bcm2835 I2C controller. read_reg reports in
+ * timestamp_ns the moment the read phase started, which is when the device
+ * latches its output registers. timestamp_ns and delay_us may be NULL to use
+ * CLOCK_MONOTONIC and bcm2835_delayMicroseconds.
+ */
+typedef struct i2c_tools_backend {
+  int (*init)(void *ctx);
+  int (*set_slave_address)(void *ctx, uint8_t slave_addr);
+  void (*set_baudrate)(void *ctx, uint32_t baudrate);
+  int (*read_reg)(void *ctx, uint8_t reg_address, char *buffer, uint8_t length,
+                  uint64_t *timestamp_ns);
+  int (*write_reg)(void *ctx, uint8_t reg_address, uint8_t data);
+  void (*cleanup)(void *ctx);
+  uint64_t (*timestamp_ns)(void *ctx);
+  void (*delay_us)(void *ctx, uint32_t micros);
+  void *ctx;
+} i2c_tools_backend_t;
+
+/*
+ * bcm2835 library lifetime. bcm2835_init maps the peripherals for the whole
+ * process and bcm2835_close unmaps them, so every user takes a reference:
+ * the bcm2835 I2C backend one per thread between init and cleanup, an SPI
+ * transport one per transport. The library is initialised by the first
+ * acquire and closed by the last release. acquire returns 0 on success.
+ */
+int i2c_tools_bcm2835_acquire(void);
+void i2c_tools_bcm2835_release(void);
+
+void i2c_tools_set_backend(const i2c_tools_backend_t *backend);
+const i2c_tools_backend_t *i2c_tools_get_backend(void);
+const i2c_tools_backend_t *i2c_tools_bcm2835_backend(void);
+
+/*
+ * Per-device bus routing. A driver whose device sits on another bus (an SPI
+ * transport, a second I2C controller) keeps that backend and activates it on
+ * entry; NULL activates the default backend set above. Transfers, delays and
+ * timestamps go through the active backend until the next selection.
+ */
+void i2c_tools_use(const i2c_tools_backend_t *bus);
+int i2c_tools_select(const i2c_tools_backend_t *bus, uint8_t slave_addr);
+
+/*
+ * Linux i2c-dev backend for /dev/i2c-<bus>, usable for any adapter the
+ * kernel exposes (i2c-1, i2c-3, i2c-4 on the carrier boards). Register reads
+ * are one combined write/read transaction with a repeated start. The bus
+ * clock comes from the device tree, set_baudrate is ignored. The state must
+ * outlive its use, and one state serves one thread at a time.
+ */
+typedef struct {
+  i2c_tools_backend_t backend;
+  char device[32];
+  int fd;
+  uint8_t slave_addr;
+} i2c_tools_i2cdev_t;
+
+const i2c_tools_backend_t *i2c_tools_i2cdev(i2c_tools_i2cdev_t *dev, int bus);
+
 int i2c_tools_init(void);
 int i2c_tools_set_slave_address(const uint8_t slave_addr);
 void i2c_tools_set_baudrate(const uint32_t baudrate);
@@ -29,6 +101,10 @@ int16_t i2c_tool_reads16_le(const uint8_t reg_address);
 uint32_t i2c_tool_read24(const uint8_t reg_address);
 int32_t i2c_tool_reads24(const uint8_t reg_address);
 void i2c_tool_cleanup(void);
+uint64_t i2c_tools_timestamp_ns(void);
+uint64_t i2c_tools_last_timestamp_ns(void);
+void i2c_tools_delay_ms(uint32_t millis);
+void i2c_tools_delay_us(uint32_t micros);
 #ifdef __cplusplus
 }
 #endif
@@ -8,41 +8,103 @@
  *
  */
 #include <i2c_tools.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdint.h>
+#include <time.h>
+#include <trace.h>
 
-static uint8_t slave_address = 0x00;
-static int ret = 0;
+static I2C_TOOLS_THREAD_LOCAL uint8_t slave_address = 0x00;
+static I2C_TOOLS_THREAD_LOCAL int ret = 0;
+static I2C_TOOLS_THREAD_LOCAL uint64_t last_timestamp_ns = 0;
 
-int i2c_tools_init(void) {
-  ret = bcm2835_init();
-  if (ret < 0) {
-    return ret;
+/* bcm2835_init maps the peripherals and bcm2835_i2c_begin reconfigures the
+ * pins for the whole process, so both are shared by every thread: each
+ * thread on the bcm2835 backend holds one reference, and the hardware is
+ * released when the last reference goes */
+static pthread_mutex_t bcm2835_lock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned int bcm2835_users = 0;
+static atomic_int bcm2835_i2c_ready = 0;
+static I2C_TOOLS_THREAD_LOCAL int bcm2835_held = 0;
+
+static uint64_t i2c_tools_monotonic_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+int i2c_tools_bcm2835_acquire(void) {
+  int result = 0;
+  pthread_mutex_lock(&bcm2835_lock);
+  if (bcm2835_users == 0 && !bcm2835_init()) {
+    result = -1;
+  } else {
+    bcm2835_users++;
   }
-  return BCM2835_I2C_REASON_OK;
+  pthread_mutex_unlock(&bcm2835_lock);
+  return result;
 }
 
-int i2c_tools_set_slave_address(const uint8_t slave_addr) {
-  ret = bcm2835_i2c_begin();
-  if (ret < 0) {
+void i2c_tools_bcm2835_release(void) {
+  pthread_mutex_lock(&bcm2835_lock);
+  if (bcm2835_users > 0 && --bcm2835_users == 0) {
+    if (atomic_load_explicit(&bcm2835_i2c_ready, memory_order_relaxed)) {
+      bcm2835_i2c_end();
+      atomic_store_explicit(&bcm2835_i2c_ready, 0, memory_order_relaxed);
+    }
     bcm2835_close();
-    return ret;
+  }
+  pthread_mutex_unlock(&bcm2835_lock);
+}
+
+static int bcm2835_backend_init(void *ctx) {
+  (void)ctx;
+  if (bcm2835_held) {
+    return BCM2835_I2C_REASON_OK;
+  }
+  if (i2c_tools_bcm2835_acquire() != 0) {
+    return -1;
+  }
+  bcm2835_held = 1;
+  return BCM2835_I2C_REASON_OK;
+}
+
+static int bcm2835_backend_set_slave_address(void *ctx, uint8_t slave_addr) {
+  (void)ctx;
+  if (!atomic_load_explicit(&bcm2835_i2c_ready, memory_order_acquire)) {
+    pthread_mutex_lock(&bcm2835_lock);
+    ret = atomic_load_explicit(&bcm2835_i2c_ready, memory_order_relaxed) ||
+          bcm2835_i2c_begin();
+    if (ret) {
+      atomic_store_explicit(&bcm2835_i2c_ready, 1, memory_order_release);
+    }
+    pthread_mutex_unlock(&bcm2835_lock);
+    if (!ret) {
+      return -1;
+    }
   }
   slave_address = slave_addr;
   bcm2835_i2c_setSlaveAddress(slave_address);
   return BCM2835_I2C_REASON_OK;
 }
 
-void i2c_tools_set_baudrate(const uint32_t baudrate) {
+static void bcm2835_backend_set_baudrate(void *ctx, uint32_t baudrate) {
+  (void)ctx;
   bcm2835_i2c_set_baudrate(baudrate);
 }
 
-int i2c_tools_read_reg(const uint8_t reg_address, char *buffer,
-                       uint8_t length) {
+static int bcm2835_backend_read_reg(void *ctx, uint8_t reg_address,
+                                    char *buffer, uint8_t length,
+                                    uint64_t *timestamp_ns) {
+  (void)ctx;
   const char reg = (char)reg_address;
   uint8_t result = bcm2835_i2c_write(&reg, 1);
   if (result != BCM2835_I2C_REASON_OK) {
     return -3;
   }
+  // The device latches its output registers when the read phase starts
+  *timestamp_ns = i2c_tools_monotonic_ns();
   result = bcm2835_i2c_read(buffer, length);
   if (result != BCM2835_I2C_REASON_OK) {
     return -3;
@@ -50,11 +112,103 @@ int i2c_tools_read_reg(const uint8_t reg_address, char *buffer,
   return 0;
 }
 
-int i2c_tool_write_reg(const uint8_t reg_address, const uint8_t data) {
+static int bcm2835_backend_write_reg(void *ctx, uint8_t reg_address,
+                                     uint8_t data) {
+  (void)ctx;
   const char buffer[2] = {(char)reg_address, (char)data};
   return bcm2835_i2c_write(buffer, 2);
 }
 
+static void bcm2835_backend_cleanup(void *ctx) {
+  (void)ctx;
+  if (bcm2835_held) {
+    bcm2835_held = 0;
+    i2c_tools_bcm2835_release();
+  }
+}
+
+static const i2c_tools_backend_t bcm2835_backend = {
+    .init = bcm2835_backend_init,
+    .set_slave_address = bcm2835_backend_set_slave_address,
+    .set_baudrate = bcm2835_backend_set_baudrate,
+    .read_reg = bcm2835_backend_read_reg,
+    .write_reg = bcm2835_backend_write_reg,
+    .cleanup = bcm2835_backend_cleanup,
+    .timestamp_ns = NULL,
+    .delay_us = NULL,
+    .ctx = NULL,
+};
+
+static I2C_TOOLS_THREAD_LOCAL const i2c_tools_backend_t *backend =
+    &bcm2835_backend;
+static I2C_TOOLS_THREAD_LOCAL const i2c_tools_backend_t *active =
+    &bcm2835_backend;
+
+const i2c_tools_backend_t *i2c_tools_bcm2835_backend(void) {
+  return &bcm2835_backend;
+}
+
+void i2c_tools_set_backend(const i2c_tools_backend_t *new_backend) {
+  backend = new_backend != NULL ? new_backend : &bcm2835_backend;
+  active = backend;
+}
+
+const i2c_tools_backend_t *i2c_tools_get_backend(void) { return backend; }
+
+void i2c_tools_use(const i2c_tools_backend_t *bus) {
+  active = bus != NULL ? bus : backend;
+}
+
+int i2c_tools_select(const i2c_tools_backend_t *bus, uint8_t slave_addr) {
+  i2c_tools_use(bus);
+  return active->set_slave_address(active->ctx, slave_addr);
+}
+
+uint64_t i2c_tools_timestamp_ns(void) {
+  if (active->timestamp_ns != NULL) {
+    return active->timestamp_ns(active->ctx);
+  }
+  return i2c_tools_monotonic_ns();
+}
+
+uint64_t i2c_tools_last_timestamp_ns(void) { return last_timestamp_ns; }
+
+void i2c_tools_delay_us(uint32_t micros) {
+  if (active->delay_us != NULL) {
+    active->delay_us(active->ctx, micros);
+  } else {
+    bcm2835_delayMicroseconds(micros);
+  }
+}
+
+void i2c_tools_delay_ms(uint32_t millis) { i2c_tools_delay_us(millis * 1000); }
+
+int i2c_tools_init(void) { return active->init(active->ctx); }
+
+int i2c_tools_set_slave_address(const uint8_t slave_addr) {
+  return active->set_slave_address(active->ctx, slave_addr);
+}
+
+void i2c_tools_set_baudrate(const uint32_t baudrate) {
+  active->set_baudrate(active->ctx, baudrate);
+}
+
+int i2c_tools_read_reg(const uint8_t reg_address, char *buffer,
+                       uint8_t length) {
+  TRACE_BEGIN(xfer);
+  int result = active->read_reg(active->ctx, reg_address, buffer, length,
+                                &last_timestamp_ns);
+  TRACE_END(xfer, "i2c_read", (uint32_t)reg_address << 8 | length);
+  return result;
+}
+
+int i2c_tool_write_reg(const uint8_t reg_address, const uint8_t data) {
+  TRACE_BEGIN(xfer);
+  int result = active->write_reg(active->ctx, reg_address, data);
+  TRACE_END(xfer, "i2c_write", (uint32_t)reg_address << 8 | data);
+  return result;
+}
+
 uint8_t i2c_tool_read_byte(const uint8_t reg_address) {
   char buffer[1];
   i2c_tools_read_reg(reg_address, buffer, 1);
@@ -93,7 +247,4 @@ int32_t i2c_tool_reads24(const uint8_t reg_address) {
   return (int32_t)i2c_tool_read24(reg_address);
 }
 
-void i2c_tool_cleanup() {
-  bcm2835_i2c_end();
-  bcm2835_close();
-}
\ No newline at end of file
+void i2c_tool_cleanup() { active->cleanup(active->ctx); }
\ No newline at end of file
@@ -0,0 +1,103 @@
+/* src - i2c_tools_i2cdev.c
+ * DESCRIPTION
+ *
+ * Linux i2c-dev backend (/dev/i2c-N) for i2c_tools.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ */
+#include <i2c_tools.h>
+#include <fcntl.h>
+#include <linux/i2c-dev.h>
+#include <linux/i2c.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include <unistd.h>
+
+static uint64_t i2cdev_monotonic_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int i2cdev_init(void *ctx) {
+  i2c_tools_i2cdev_t *dev = (i2c_tools_i2cdev_t *)ctx;
+  if (dev->fd >= 0) {
+    return 0;
+  }
+  dev->fd = open(dev->device, O_RDWR | O_CLOEXEC);
+  if (dev->fd < 0) {
+    fprintf(stderr, "Error opening %s\n", dev->device);
+    return -1;
+  }
+  return 0;
+}
+
+static int i2cdev_set_slave_address(void *ctx, uint8_t slave_addr) {
+  // Addresses travel with every I2C_RDWR message, no syscall needed here
+  i2c_tools_i2cdev_t *dev = (i2c_tools_i2cdev_t *)ctx;
+  dev->slave_addr = slave_addr;
+  return 0;
+}
+
+static void i2cdev_set_baudrate(void *ctx, uint32_t baudrate) {
+  (void)ctx;
+  (void)baudrate;
+}
+
+static int i2cdev_read_reg(void *ctx, uint8_t reg_address, char *buffer,
+                           uint8_t length, uint64_t *timestamp_ns) {
+  i2c_tools_i2cdev_t *dev = (i2c_tools_i2cdev_t *)ctx;
+  struct i2c_msg msgs[2] = {
+      {.addr = dev->slave_addr, .flags = 0, .len = 1, .buf = &reg_address},
+      {.addr = dev->slave_addr,
+       .flags = I2C_M_RD,
+       .len = length,
+       .buf = (uint8_t *)buffer},
+  };
+  struct i2c_rdwr_ioctl_data transfer = {.msgs = msgs, .nmsgs = 2};
+  // The register byte is a few tens of microseconds, the latch follows it
+  *timestamp_ns = i2cdev_monotonic_ns();
+  return ioctl(dev->fd, I2C_RDWR, &transfer) < 0 ? -3 : 0;
+}
+
+static int i2cdev_write_reg(void *ctx, uint8_t reg_address, uint8_t data) {
+  i2c_tools_i2cdev_t *dev = (i2c_tools_i2cdev_t *)ctx;
+  uint8_t buffer[2] = {reg_address, data};
+  struct i2c_msg msg = {
+      .addr = dev->slave_addr, .flags = 0, .len = 2, .buf = buffer};
+  struct i2c_rdwr_ioctl_data transfer = {.msgs = &msg, .nmsgs = 1};
+  return ioctl(dev->fd, I2C_RDWR, &transfer) < 0 ? -3 : 0;
+}
+
+static void i2cdev_cleanup(void *ctx) {
+  i2c_tools_i2cdev_t *dev = (i2c_tools_i2cdev_t *)ctx;
+  if (dev->fd >= 0) {
+    close(dev->fd);
+    dev->fd = -1;
+  }
+}
+
+static void i2cdev_delay_us(void *ctx, uint32_t micros) {
+  (void)ctx;
+  struct timespec ts = {(time_t)(micros / 1000000),
+                        (long)(micros % 1000000) * 1000};
+  nanosleep(&ts, NULL);
+}
+
+const i2c_tools_backend_t *i2c_tools_i2cdev(i2c_tools_i2cdev_t *dev, int bus) {
+  memset(dev, 0, sizeof(*dev));
+  snprintf(dev->device, sizeof(dev->device), "/dev/i2c-%d", bus);
+  dev->fd = -1;
+  dev->backend.init = i2cdev_init;
+  dev->backend.set_slave_address = i2cdev_set_slave_address;
+  dev->backend.set_baudrate = i2cdev_set_baudrate;
+  dev->backend.read_reg = i2cdev_read_reg;
+  dev->backend.write_reg = i2cdev_write_reg;
+  dev->backend.cleanup = i2cdev_cleanup;
+  dev->backend.delay_us = i2cdev_delay_us;
+  dev->backend.ctx = dev;
+  return &dev->backend;
+}
@@ -0,0 +1,159 @@
+/**
+ * @file mpu6050_batch_bench.c
+ * @brief Check the batch conversion kernel against the scalar reference
+ *
+ * Converts pseudo-random FIFO frames with the kernel selected at build
+ * time (SSE2, NEON or scalar), with the scalar loop and with the
+ * expression mpu6050_get_acce()/mpu6050_get_gyro() use, and requires all
+ * three to agree bit for bit. Frame counts that are not a multiple of four
+ * exercise the remainder loop. It then times both paths and prints the
+ * cost per frame. Built with -DCOREFLIGHT_BENCH=ON; exits non-zero on a
+ * mismatch.
+ *
+ *   mpu6050_batch_bench [frames] [rounds]
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "mpu6050.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/** @brief Frames per conversion call when timing */
+#define BENCH_DEFAULT_FRAMES (1024)
+
+/** @brief Timed calls per path */
+#define BENCH_DEFAULT_ROUNDS (2000)
+
+static uint64_t bench_now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t bench_random(uint32_t *state) {
+  // xorshift32: reproducible frames on every platform
+  *state ^= *state << 13;
+  *state ^= *state >> 17;
+  *state ^= *state << 5;
+  return *state;
+}
+
+typedef struct {
+  float *axis[6];
+  float *memory;
+} bench_out_t;
+
+static int bench_out_init(bench_out_t *out, size_t frames,
+                          mpu6050_batch_out_t *view) {
+  out->memory = malloc(6 * frames * sizeof(float));
+  if (out->memory == NULL) {
+    return -1;
+  }
+  for (int k = 0; k < 6; k++) {
+    out->axis[k] = out->memory + k * frames;
+  }
+  view->acce_x = out->axis[0];
+  view->acce_y = out->axis[1];
+  view->acce_z = out->axis[2];
+  view->gyro_x = out->axis[3];
+  view->gyro_y = out->axis[4];
+  view->gyro_z = out->axis[5];
+  return 0;
+}
+
+/**
+ * @brief Compare a conversion with the single-sample driver expression
+ * @return Number of values that differ
+ */
+static size_t bench_check(const uint8_t *frames, size_t count,
+                          const int16_t bias[6], const float sens[6],
+                          const bench_out_t *out) {
+  size_t errors = 0;
+  for (size_t i = 0; i < count; i++) {
+    const uint8_t *frame = &frames[i * MPU6050_FIFO_FRAME_SIZE];
+    for (int k = 0; k < 6; k++) {
+      int16_t raw = (int16_t)((frame[2 * k] << 8) | frame[2 * k + 1]);
+      float expected = (raw - bias[k]) / sens[k];
+      if (memcmp(&expected, &out->axis[k][i], sizeof(float)) != 0) {
+        errors++;
+      }
+    }
+  }
+  return errors;
+}
+
+int main(int argc, char **argv) {
+  static const float acce_sens[4] = {16384, 8192, 4096, 2048};
+  static const float gyro_sens[4] = {131, 65.5, 32.8, 16.4};
+  size_t frames = argc > 1 ? strtoul(argv[1], NULL, 0) : BENCH_DEFAULT_FRAMES;
+  size_t rounds = argc > 2 ? strtoul(argv[2], NULL, 0) : BENCH_DEFAULT_ROUNDS;
+  if (frames == 0 || rounds == 0) {
+    fprintf(stderr, "usage: %s [frames] [rounds]\n", argv[0]);
+    return 2;
+  }
+
+  uint8_t *raw = malloc(frames * MPU6050_FIFO_FRAME_SIZE);
+  bench_out_t kernel, scalar;
+  mpu6050_batch_out_t kernel_view, scalar_view;
+  if (raw == NULL || bench_out_init(&kernel, frames, &kernel_view) != 0 ||
+      bench_out_init(&scalar, frames, &scalar_view) != 0) {
+    fprintf(stderr, "Error allocating %zu frames\n", frames);
+    return 2;
+  }
+  uint32_t state = 0x12345678;
+  for (size_t i = 0; i < frames * MPU6050_FIFO_FRAME_SIZE; i++) {
+    raw[i] = (uint8_t)bench_random(&state);
+  }
+
+  // Every range, each with its own biases, over every remainder length
+  size_t errors = 0;
+  for (int range = 0; range < 4; range++) {
+    mpu6050_batch_params_t params;
+    int16_t bias[6];
+    for (int k = 0; k < 6; k++) {
+      bias[k] = (int16_t)(bench_random(&state) % 2001) - 1000;
+      params.bias[k] = bias[k];
+      params.sensitivity[k] = k < 3 ? acce_sens[range] : gyro_sens[range];
+    }
+    for (size_t count = frames > 3 ? frames - 3 : 1; count <= frames;
+         count++) {
+      mpu6050_batch_convert(raw, count, &params, &kernel_view);
+      mpu6050_batch_convert_scalar(raw, count, &params, &scalar_view);
+      errors += bench_check(raw, count, bias, params.sensitivity, &kernel);
+      errors += bench_check(raw, count, bias, params.sensitivity, &scalar);
+    }
+  }
+  printf("kernel %s: %zu frames x 4 ranges, %zu mismatches\n",
+         mpu6050_batch_kernel(), frames, errors);
+
+  mpu6050_batch_params_t params;
+  for (int k = 0; k < 6; k++) {
+    params.bias[k] = 0;
+    params.sensitivity[k] = k < 3 ? acce_sens[1] : gyro_sens[1];
+  }
+  uint64_t start = bench_now_ns();
+  for (size_t r = 0; r < rounds; r++) {
+    mpu6050_batch_convert(raw, frames, &params, &kernel_view);
+  }
+  uint64_t kernel_ns = bench_now_ns() - start;
+  start = bench_now_ns();
+  for (size_t r = 0; r < rounds; r++) {
+    mpu6050_batch_convert_scalar(raw, frames, &params, &scalar_view);
+  }
+  uint64_t scalar_ns = bench_now_ns() - start;
+
+  double per_frame = (double)(frames * rounds);
+  printf("%-7s %8.2f ns/frame\n", mpu6050_batch_kernel(),
+         (double)kernel_ns / per_frame);
+  printf("%-7s %8.2f ns/frame\n", "scalar", (double)scalar_ns / per_frame);
+
+  free(raw);
+  free(kernel.memory);
+  free(scalar.memory);
+  return errors != 0;
+}
@@ -14,15 +14,37 @@ extern "C" {
 #endif
 
 #include "i2c_tools.h"
+#include <stddef.h>
 
 /** @brief Default I2C address for MPU6050 */
 #define MPU6050_ADDRESS (0x68) ///< MPU6050 default i2c address w/ AD0 high
 
+/** @brief I2C address with the AD0 pin pulled the other way */
+#define MPU6050_ADDRESS_ALTERNATE (0x69)
+
+/** @brief WHO_AM_I value, the same at either address */
+#define MPU6050_CHIP_ID (0x68)
+
+/** @brief Gyroscope start-up time from sleep (datasheet, µs) */
+#define MPU6050_STARTUP_US (30000)
+
 enum {
+  MPU6050_XA_OFFS_H = 0x06,
+  MPU6050_XA_OFFS_L = 0x07,
+  MPU6050_YA_OFFS_H = 0x08,
+  MPU6050_YA_OFFS_L = 0x09,
+  MPU6050_ZA_OFFS_H = 0x0A,
+  MPU6050_ZA_OFFS_L = 0x0B,
   MPU6050_SELF_TEST_X = 0x0D,
   MPU6050_SELF_TEST_Y = 0x0E,
   MPU6050_SELF_TEST_Z = 0x0F,
   MPU6050_SELF_TEST_A = 0x10,
+  MPU6050_XG_OFFS_USRH = 0x13,
+  MPU6050_XG_OFFS_USRL = 0x14,
+  MPU6050_YG_OFFS_USRH = 0x15,
+  MPU6050_YG_OFFS_USRL = 0x16,
+  MPU6050_ZG_OFFS_USRH = 0x17,
+  MPU6050_ZG_OFFS_USRL = 0x18,
   MPU6050_SMPLRT_DIV = 0x19,
   MPU6050_CONFIG = 0x1A,
   MPU6050_GYRO_CONFIG = 0x1B,
@@ -202,24 +224,28 @@ typedef enum {
 } mpu6050_cycle_rate_t;
 
 typedef struct {
+  uint64_t timestamp_ns;
   int16_t raw_acce_x;
   int16_t raw_acce_y;
   int16_t raw_acce_z;
 } mpu6050_raw_acce_value_t;
 
 typedef struct {
+  uint64_t timestamp_ns;
   int16_t raw_gyro_x;
   int16_t raw_gyro_y;
   int16_t raw_gyro_z;
 } mpu6050_raw_gyro_value_t;
 
 typedef struct {
+  uint64_t timestamp_ns;
   float acce_x;
   float acce_y;
   float acce_z;
 } mpu6050_acce_value_t;
 
 typedef struct {
+  uint64_t timestamp_ns;
   float gyro_x;
   float gyro_y;
   float gyro_z;
@@ -230,7 +256,55 @@ typedef struct {
   float pitch;
 } complimentary_angle_t;
 
+/** @brief Bytes per FIFO frame (accelerometer XYZ followed by gyroscope XYZ) */
+#define MPU6050_FIFO_FRAME_SIZE (12)
+
+/** @brief Size of the on-chip FIFO in bytes */
+#define MPU6050_FIFO_SIZE (1024)
+
+/**
+ * @brief FIFO timestamp reconstruction state
+ *
+ * Frames are spaced by the configured output data rate and anchored to the
+ * host time of each drain. The period estimate is slowly steered towards the
+ * observed host-clock rate so the MPU6050 oscillator drift does not
+ * accumulate.
+ */
+typedef struct {
+  double nominal_ns; ///< Frame period derived from the configured ODR
+  double period_ns;  ///< Drift-corrected frame period
+  uint64_t last_ns;  ///< Timestamp of the newest frame handed out
+  int synced;        ///< Non-zero once anchored to a drain
+} mpu6050_fifo_clock_t;
+
+/**
+ * @brief Conversion parameters for batches of FIFO frames
+ *
+ * Axes are ordered acce x, y, z, gyro x, y, z. Each value is computed as
+ * (raw - bias) / sensitivity, as mpu6050_get_acce() and mpu6050_get_gyro()
+ * do, so both paths give bit-identical results for g and deg/s.
+ */
+typedef struct {
+  float bias[6];        ///< Raw offsets subtracted first (LSB)
+  float sensitivity[6]; ///< Divisors applied after the bias (LSB per unit)
+} mpu6050_batch_params_t;
+
+/**
+ * @brief Structure-of-arrays destination, one array of count floats per axis
+ */
+typedef struct {
+  float *acce_x;
+  float *acce_y;
+  float *acce_z;
+  float *gyro_x;
+  float *gyro_y;
+  float *gyro_z;
+} mpu6050_batch_out_t;
+
+void mpu6050_set_bus(const i2c_tools_backend_t *transport);
 int mpu6050_begin(uint8_t slave);
+int mpu6050_start(uint8_t slave);
+uint64_t mpu6050_ready_ns(void);
 void mpu6050_get_raw_gyro(mpu6050_raw_gyro_value_t *raw_gyro_value);
 void mpu6050_get_raw_acce(mpu6050_raw_acce_value_t *raw_acce_value);
 float mpu6050_get_acce_sensitivity(void);
@@ -240,6 +314,49 @@ int mpu6050_get_acce(mpu6050_acce_value_t *acce_value);
 int mpu6050_set_gyro_fs(mpu6050_gyro_range_t gyro_fs);
 int mpu6050_set_acce_fs(mpu6050_accel_range_t acce_fs);
 int mpu6050_wake_up(void);
+void mpu6050_set_acce_bias(const int16_t bias[3]);
+void mpu6050_set_gyro_bias(const int16_t bias[3]);
+mpu6050_accel_range_t mpu6050_get_acce_fs(void);
+mpu6050_gyro_range_t mpu6050_get_gyro_fs(void);
+/*
+ * Offset registers. The first adjustment reads the offsets as found (the
+ * factory trim after power-up) and caches them; every adjustment then
+ * writes that value minus the bias, so applying twice does not subtract
+ * twice. Restoring writes the cached values back, and is a no-op before
+ * the first adjustment. The cache lives in the process: adjusted offsets
+ * persist until the next power cycle, so a later process that adjusts
+ * again must not find them already adjusted (power-cycle the sensor, or
+ * restore before exiting).
+ */
+int mpu6050_adjust_offset_registers(const int16_t acce_bias[3],
+                                    const int16_t gyro_bias[3]);
+int mpu6050_restore_offset_registers(void);
+int mpu6050_set_filter_bandwidth(mpu6050_bandwidth_t bandwidth);
+int mpu6050_set_sample_rate_div(uint8_t divider);
+float mpu6050_get_sample_rate(void);
+int mpu6050_fifo_begin(void);
+int mpu6050_fifo_reset(void);
+int mpu6050_fifo_read(uint8_t *buffer, size_t max_frames, uint64_t *drain_ns,
+                      size_t *backlog);
+void mpu6050_fifo_clock_init(mpu6050_fifo_clock_t *clock, float odr_hz);
+void mpu6050_fifo_timestamps(mpu6050_fifo_clock_t *clock, uint64_t drain_ns,
+                             size_t frames, size_t backlog,
+                             uint64_t *timestamps);
+int mpu6050_fifo_drain(mpu6050_fifo_clock_t *clock,
+                       mpu6050_raw_acce_value_t *raw_acce,
+                       mpu6050_raw_gyro_value_t *raw_gyro, size_t max_frames);
+int mpu6050_fifo_drain_batch(mpu6050_fifo_clock_t *clock,
+                             const mpu6050_batch_params_t *params,
+                             const mpu6050_batch_out_t *out,
+                             uint64_t *timestamps, size_t max_frames);
+int mpu6050_batch_params(mpu6050_batch_params_t *params);
+void mpu6050_batch_convert(const uint8_t *frames, size_t count,
+                           const mpu6050_batch_params_t *params,
+                           const mpu6050_batch_out_t *out);
+void mpu6050_batch_convert_scalar(const uint8_t *frames, size_t count,
+                                  const mpu6050_batch_params_t *params,
+                                  const mpu6050_batch_out_t *out);
+const char *mpu6050_batch_kernel(void);
 
 #ifdef __cplusplus
 }
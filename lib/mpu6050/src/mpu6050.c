@@ -2,8 +2,24 @@
 #include <math.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <trace.h>
 
-static uint8_t slave_addr = 0x0;
+static I2C_TOOLS_THREAD_LOCAL uint8_t slave_addr = 0x0;
+
+/** @brief Time the gyroscope has settled after wake-up (monotonic ns) */
+static I2C_TOOLS_THREAD_LOCAL uint64_t ready_ns = 0;
+
+/** @brief Transport of the sensor, NULL for the default I2C backend */
+static I2C_TOOLS_THREAD_LOCAL const i2c_tools_backend_t *bus = NULL;
+
+/** @brief Raw offsets subtracted on the conversion path (LSB) */
+static I2C_TOOLS_THREAD_LOCAL int16_t acce_bias[3] = {0, 0, 0};
+static I2C_TOOLS_THREAD_LOCAL int16_t gyro_bias[3] = {0, 0, 0};
+
+/** @brief Offset registers as found before the first adjustment, accel XYZ
+ * then gyro XYZ, and the address they were read from (-1 if not read) */
+static I2C_TOOLS_THREAD_LOCAL int16_t factory_offsets[6];
+static I2C_TOOLS_THREAD_LOCAL int factory_slave = -1;
 
 #define BIT0 (1 << 0) // 0x01
 #define BIT1 (1 << 1) // 0x02
@@ -14,10 +30,26 @@ static uint8_t slave_addr = 0x0;
 #define BIT6 (1 << 6) // 0x40
 #define BIT7 (1 << 7) // 0x80
 
+/** @brief Largest FIFO burst that fits the 8-bit i2c_tools length */
+#define MPU6050_FIFO_CHUNK_FRAMES (255 / MPU6050_FIFO_FRAME_SIZE)
+
+/** @brief Gain applied to the drain-time phase error on every drain */
+#define MPU6050_FIFO_PHASE_GAIN (0.1)
+
+/** @brief Gain applied to the per-frame period error on every drain */
+#define MPU6050_FIFO_PERIOD_GAIN (0.01)
+
+/** @brief Maximum oscillator deviation accepted from the nominal period */
+#define MPU6050_FIFO_PERIOD_TOLERANCE (0.05)
+
+/** @brief Phase error (in frames) after which the clock is re-anchored */
+#define MPU6050_FIFO_RESYNC_FRAMES (8)
+
 void mpu6050_get_raw_gyro(mpu6050_raw_gyro_value_t *raw_gyro_value) {
   char buffer[6] = {0};
   i2c_tools_read_reg(MPU6050_GYRO_XOUT_H, buffer, 6);
 
+  raw_gyro_value->timestamp_ns = i2c_tools_last_timestamp_ns();
   raw_gyro_value->raw_gyro_x =
       (int16_t)(((uint8_t)buffer[0] << 8) + ((uint8_t)buffer[1]));
   raw_gyro_value->raw_gyro_y =
@@ -30,6 +62,7 @@ void mpu6050_get_raw_acce(mpu6050_raw_acce_value_t *raw_acce_value) {
   char buffer[6] = {0};
   i2c_tools_read_reg(MPU6050_ACCEL_XOUT_H, buffer, 6);
 
+  raw_acce_value->timestamp_ns = i2c_tools_last_timestamp_ns();
   raw_acce_value->raw_acce_x =
       (int16_t)(((uint8_t)buffer[0] << 8) + ((uint8_t)buffer[1]));
   raw_acce_value->raw_acce_y =
@@ -39,7 +72,7 @@ void mpu6050_get_raw_acce(mpu6050_raw_acce_value_t *raw_acce_value) {
 }
 
 float mpu6050_get_acce_sensitivity(void) {
-  i2c_tools_set_slave_address(slave_addr);
+  i2c_tools_select(bus, slave_addr);
   float acce_sensitivity = 0;
   uint8_t acce_fs = i2c_tool_read_byte(MPU6050_ACCEL_CONFIG);
   acce_fs = (acce_fs >> 3) & 0x03;
@@ -63,9 +96,9 @@ float mpu6050_get_acce_sensitivity(void) {
 }
 
 float mpu6050_get_gyro_sensitivity(void) {
-  i2c_tools_set_slave_address(slave_addr);
+  i2c_tools_select(bus, slave_addr);
   float gyro_sensitivity = 0;
-  uint8_t gyro_fs = i2c_tool_read_byte(MPU6050_ACCEL_CONFIG);
+  uint8_t gyro_fs = i2c_tool_read_byte(MPU6050_GYRO_CONFIG);
   gyro_fs = (gyro_fs >> 3) & 0x03;
   switch (gyro_fs) {
   case MPU6050_RANGE_250_DEG:
@@ -92,9 +125,10 @@ int mpu6050_get_gyro(mpu6050_gyro_value_t *gyro_value) {
   float gyro_sensitivity = mpu6050_get_gyro_sensitivity();
   mpu6050_get_raw_gyro(&raw_gyro);
 
-  gyro_value->gyro_x = raw_gyro.raw_gyro_x / gyro_sensitivity;
-  gyro_value->gyro_y = raw_gyro.raw_gyro_y / gyro_sensitivity;
-  gyro_value->gyro_z = raw_gyro.raw_gyro_z / gyro_sensitivity;
+  gyro_value->timestamp_ns = raw_gyro.timestamp_ns;
+  gyro_value->gyro_x = (raw_gyro.raw_gyro_x - gyro_bias[0]) / gyro_sensitivity;
+  gyro_value->gyro_y = (raw_gyro.raw_gyro_y - gyro_bias[1]) / gyro_sensitivity;
+  gyro_value->gyro_z = (raw_gyro.raw_gyro_z - gyro_bias[2]) / gyro_sensitivity;
   return 0;
 }
 
@@ -104,14 +138,116 @@ int mpu6050_get_acce(mpu6050_acce_value_t *acce_value) {
   float acce_sensitivity = mpu6050_get_acce_sensitivity();
   mpu6050_get_raw_acce(&raw_acce);
 
-  acce_value->acce_x = raw_acce.raw_acce_x / acce_sensitivity;
-  acce_value->acce_y = raw_acce.raw_acce_y / acce_sensitivity;
-  acce_value->acce_z = raw_acce.raw_acce_z / acce_sensitivity;
+  acce_value->timestamp_ns = raw_acce.timestamp_ns;
+  acce_value->acce_x = (raw_acce.raw_acce_x - acce_bias[0]) / acce_sensitivity;
+  acce_value->acce_y = (raw_acce.raw_acce_y - acce_bias[1]) / acce_sensitivity;
+  acce_value->acce_z = (raw_acce.raw_acce_z - acce_bias[2]) / acce_sensitivity;
+  return 0;
+}
+
+void mpu6050_set_acce_bias(const int16_t bias[3]) {
+  acce_bias[0] = bias[0];
+  acce_bias[1] = bias[1];
+  acce_bias[2] = bias[2];
+}
+
+void mpu6050_set_gyro_bias(const int16_t bias[3]) {
+  gyro_bias[0] = bias[0];
+  gyro_bias[1] = bias[1];
+  gyro_bias[2] = bias[2];
+}
+
+mpu6050_accel_range_t mpu6050_get_acce_fs(void) {
+  i2c_tools_select(bus, slave_addr);
+  uint8_t acce_fs = i2c_tool_read_byte(MPU6050_ACCEL_CONFIG);
+  return (mpu6050_accel_range_t)((acce_fs >> 3) & 0x03);
+}
+
+mpu6050_gyro_range_t mpu6050_get_gyro_fs(void) {
+  i2c_tools_select(bus, slave_addr);
+  uint8_t gyro_fs = i2c_tool_read_byte(MPU6050_GYRO_CONFIG);
+  return (mpu6050_gyro_range_t)((gyro_fs >> 3) & 0x03);
+}
+
+/**
+ * @brief Read the offset registers once per device, before any adjustment
+ */
+static void mpu6050_load_factory_offsets(void) {
+  if (factory_slave == slave_addr) {
+    return;
+  }
+  for (int axis = 0; axis < 3; axis++) {
+    factory_offsets[axis] = i2c_tool_reads16(MPU6050_XA_OFFS_H + 2 * axis);
+    factory_offsets[axis + 3] =
+        i2c_tool_reads16(MPU6050_XG_OFFS_USRH + 2 * axis);
+  }
+  factory_slave = slave_addr;
+}
+
+static int mpu6050_write_offset(uint8_t reg, int32_t value) {
+  int ret = i2c_tool_write_reg(reg, (uint8_t)(value >> 8));
+  ret |= i2c_tool_write_reg(reg + 1, (uint8_t)value);
+  return ret;
+}
+
+int mpu6050_adjust_offset_registers(const int16_t acce_bias[3],
+                                    const int16_t gyro_bias[3]) {
+  // Accel offsets are in +/-16g units, gyro offsets in +/-1000 deg/s units
+  int acce_shift = 3 - mpu6050_get_acce_fs();
+  int gyro_fs = mpu6050_get_gyro_fs();
+  i2c_tools_select(bus, slave_addr);
+  mpu6050_load_factory_offsets();
+
+  // Absolute values from the cached factory offsets, so applying again
+  // replaces the previous adjustment instead of adding to it
+  for (int axis = 0; axis < 3; axis++) {
+    int16_t factory = factory_offsets[axis];
+    int32_t adjusted = factory - acce_bias[axis] / (1 << acce_shift);
+
+    // Bit 0 is reserved for the factory temperature compensation
+    adjusted = (adjusted & ~1) | (factory & 1);
+    int ret = mpu6050_write_offset(MPU6050_XA_OFFS_H + 2 * axis, adjusted);
+    if (ret != 0) {
+      return ret;
+    }
+  }
+
+  for (int axis = 0; axis < 3; axis++) {
+    int32_t bias = gyro_bias[axis];
+    if (gyro_fs < MPU6050_RANGE_1000_DEG) {
+      bias /= (1 << (MPU6050_RANGE_1000_DEG - gyro_fs));
+    } else if (gyro_fs > MPU6050_RANGE_1000_DEG) {
+      bias *= 2;
+    }
+    int32_t adjusted = factory_offsets[axis + 3] - bias;
+    int ret = mpu6050_write_offset(MPU6050_XG_OFFS_USRH + 2 * axis, adjusted);
+    if (ret != 0) {
+      return ret;
+    }
+  }
+  return 0;
+}
+
+int mpu6050_restore_offset_registers(void) {
+  i2c_tools_select(bus, slave_addr);
+  if (factory_slave != slave_addr) {
+    // Never adjusted by this thread, the registers are as found
+    return 0;
+  }
+  for (int axis = 0; axis < 3; axis++) {
+    int ret = mpu6050_write_offset(MPU6050_XA_OFFS_H + 2 * axis,
+                                   factory_offsets[axis]);
+    ret |= mpu6050_write_offset(MPU6050_XG_OFFS_USRH + 2 * axis,
+                                factory_offsets[axis + 3]);
+    if (ret != 0) {
+      return ret;
+    }
+  }
   return 0;
 }
 
 int mpu6050_set_gyro_fs(mpu6050_gyro_range_t gyro_fs) {
-  i2c_tools_set_slave_address(slave_addr);
+  i2c_tools_select(bus, slave_addr);
   uint8_t tmp = i2c_tool_read_byte(MPU6050_GYRO_CONFIG);
 
   // Set the bit 3 and 4 to put in select
@@ -122,7 +258,7 @@ int mpu6050_set_gyro_fs(mpu6050_gyro_range_t gyro_fs) {
 }
 
 int mpu6050_set_acce_fs(mpu6050_accel_range_t acce_fs) {
-  i2c_tools_set_slave_address(slave_addr);
+  i2c_tools_select(bus, slave_addr);
   uint8_t tmp = i2c_tool_read_byte(MPU6050_ACCEL_CONFIG);
 
   // Set the bit 3 and 4 to put in select
@@ -133,7 +269,7 @@ int mpu6050_set_acce_fs(mpu6050_accel_range_t acce_fs) {
 }
 
 int mpu6050_wake_up(void) {
-  i2c_tools_set_slave_address(slave_addr);
+  i2c_tools_select(bus, slave_addr);
   uint8_t tmp = i2c_tool_read_byte(MPU6050_PWR_MGMT_1);
 
   // Set the bit 6 to wake up
@@ -141,7 +277,222 @@ int mpu6050_wake_up(void) {
   return i2c_tool_write_reg(MPU6050_PWR_MGMT_1, tmp);
 }
 
+int mpu6050_set_filter_bandwidth(mpu6050_bandwidth_t bandwidth) {
+  i2c_tools_select(bus, slave_addr);
+  uint8_t tmp = i2c_tool_read_byte(MPU6050_CONFIG);
+
+  // DLPF_CFG lives in bits 0 to 2
+  tmp &= ~(BIT0 | BIT1 | BIT2);
+  tmp |= (bandwidth & 0x07);
+  return i2c_tool_write_reg(MPU6050_CONFIG, tmp);
+}
+
+int mpu6050_set_sample_rate_div(uint8_t divider) {
+  i2c_tools_select(bus, slave_addr);
+  return i2c_tool_write_reg(MPU6050_SMPLRT_DIV, divider);
+}
+
+float mpu6050_get_sample_rate(void) {
+  i2c_tools_select(bus, slave_addr);
+  uint8_t dlpf_cfg = i2c_tool_read_byte(MPU6050_CONFIG) & 0x07;
+  uint8_t divider = i2c_tool_read_byte(MPU6050_SMPLRT_DIV);
+
+  // The gyro output rate is 8 kHz with the DLPF disabled, 1 kHz otherwise
+  float gyro_rate = (dlpf_cfg == 0 || dlpf_cfg == 7) ? 8000.0f : 1000.0f;
+  return gyro_rate / (1.0f + divider);
+}
+
+int mpu6050_fifo_reset(void) {
+  i2c_tools_select(bus, slave_addr);
+  uint8_t tmp = i2c_tool_read_byte(MPU6050_USER_CTRL);
+
+  // Bit 2 clears the FIFO, bit 6 keeps it enabled
+  tmp |= BIT2;
+  return i2c_tool_write_reg(MPU6050_USER_CTRL, tmp);
+}
+
+int mpu6050_fifo_begin(void) {
+  i2c_tools_select(bus, slave_addr);
+
+  // Accelerometer (bit 3) and the three gyroscope axes (bits 4 to 6)
+  int ret = i2c_tool_write_reg(MPU6050_FIFO_EN, BIT3 | BIT4 | BIT5 | BIT6);
+  if (ret != 0) {
+    return ret;
+  }
+  uint8_t tmp = i2c_tool_read_byte(MPU6050_USER_CTRL);
+  tmp |= BIT6;
+  ret = i2c_tool_write_reg(MPU6050_USER_CTRL, tmp);
+  if (ret != 0) {
+    return ret;
+  }
+  return mpu6050_fifo_reset();
+}
+
+int mpu6050_fifo_read(uint8_t *buffer, size_t max_frames, uint64_t *drain_ns,
+                      size_t *backlog) {
+  i2c_tools_select(bus, slave_addr);
+  char count_buffer[2];
+  if (i2c_tools_read_reg(MPU6050_FIFO_COUNTH, count_buffer, 2) != 0) {
+    return -3;
+  }
+  *drain_ns = i2c_tools_last_timestamp_ns();
+
+  size_t count = ((size_t)(uint8_t)count_buffer[0] << 8) |
+                 (size_t)(uint8_t)count_buffer[1];
+  if (count >= MPU6050_FIFO_SIZE || (count % MPU6050_FIFO_FRAME_SIZE) != 0) {
+    // Overflowed or misaligned: frame boundaries are lost, start over
+    mpu6050_fifo_reset();
+    return -2;
+  }
+
+  size_t available = count / MPU6050_FIFO_FRAME_SIZE;
+  size_t frames = available < max_frames ? available : max_frames;
+  size_t done = 0;
+  while (done < frames) {
+    size_t chunk = frames - done;
+    if (chunk > MPU6050_FIFO_CHUNK_FRAMES) {
+      chunk = MPU6050_FIFO_CHUNK_FRAMES;
+    }
+    if (i2c_tools_read_reg(MPU6050_FIFO_R_W,
+                           (char *)&buffer[done * MPU6050_FIFO_FRAME_SIZE],
+                           (uint8_t)(chunk * MPU6050_FIFO_FRAME_SIZE)) != 0) {
+      return -3;
+    }
+    done += chunk;
+  }
+  *backlog = available - frames;
+  return (int)frames;
+}
+
+void mpu6050_fifo_clock_init(mpu6050_fifo_clock_t *clock, float odr_hz) {
+  clock->nominal_ns = 1e9 / odr_hz;
+  clock->period_ns = clock->nominal_ns;
+  clock->last_ns = 0;
+  clock->synced = 0;
+}
+
+void mpu6050_fifo_timestamps(mpu6050_fifo_clock_t *clock, uint64_t drain_ns,
+                             size_t frames, size_t backlog,
+                             uint64_t *timestamps) {
+  if (frames == 0) {
+    return;
+  }
+
+  // Host-time estimate of the newest frame that was actually read
+  double measured = (double)drain_ns - (double)backlog * clock->period_ns;
+  double newest = measured;
+
+  if (clock->synced) {
+    double predicted =
+        (double)clock->last_ns + (double)frames * clock->period_ns;
+    double error = measured - predicted;
+
+    if (error > -MPU6050_FIFO_RESYNC_FRAMES * clock->period_ns &&
+        error < MPU6050_FIFO_RESYNC_FRAMES * clock->period_ns) {
+      newest = predicted + MPU6050_FIFO_PHASE_GAIN * error;
+      clock->period_ns += MPU6050_FIFO_PERIOD_GAIN * error / (double)frames;
+
+      double min_period =
+          clock->nominal_ns * (1.0 - MPU6050_FIFO_PERIOD_TOLERANCE);
+      double max_period =
+          clock->nominal_ns * (1.0 + MPU6050_FIFO_PERIOD_TOLERANCE);
+      if (clock->period_ns < min_period) {
+        clock->period_ns = min_period;
+      } else if (clock->period_ns > max_period) {
+        clock->period_ns = max_period;
+      }
+    }
+  }
+
+  // A frame can never be newer than the moment its count was read
+  if (newest > (double)drain_ns) {
+    newest = (double)drain_ns;
+  }
+
+  for (size_t i = 0; i < frames; i++) {
+    timestamps[i] =
+        (uint64_t)(newest - (double)(frames - 1 - i) * clock->period_ns);
+  }
+  clock->last_ns = timestamps[frames - 1];
+  clock->synced = 1;
+}
+
+int mpu6050_fifo_drain(mpu6050_fifo_clock_t *clock,
+                       mpu6050_raw_acce_value_t *raw_acce,
+                       mpu6050_raw_gyro_value_t *raw_gyro, size_t max_frames) {
+  uint8_t buffer[MPU6050_FIFO_SIZE];
+  uint64_t timestamps[MPU6050_FIFO_SIZE / MPU6050_FIFO_FRAME_SIZE];
+  uint64_t drain_ns;
+  size_t backlog;
+
+  if (max_frames > MPU6050_FIFO_SIZE / MPU6050_FIFO_FRAME_SIZE) {
+    max_frames = MPU6050_FIFO_SIZE / MPU6050_FIFO_FRAME_SIZE;
+  }
+  int frames = mpu6050_fifo_read(buffer, max_frames, &drain_ns, &backlog);
+  if (frames < 0) {
+    clock->synced = 0;
+    return frames;
+  }
+  mpu6050_fifo_timestamps(clock, drain_ns, (size_t)frames, backlog,
+                          timestamps);
+
+  for (int i = 0; i < frames; i++) {
+    const uint8_t *frame = &buffer[i * MPU6050_FIFO_FRAME_SIZE];
+    raw_acce[i].timestamp_ns = timestamps[i];
+    raw_acce[i].raw_acce_x = (int16_t)((frame[0] << 8) + frame[1]);
+    raw_acce[i].raw_acce_y = (int16_t)((frame[2] << 8) + frame[3]);
+    raw_acce[i].raw_acce_z = (int16_t)((frame[4] << 8) + frame[5]);
+    raw_gyro[i].timestamp_ns = timestamps[i];
+    raw_gyro[i].raw_gyro_x = (int16_t)((frame[6] << 8) + frame[7]);
+    raw_gyro[i].raw_gyro_y = (int16_t)((frame[8] << 8) + frame[9]);
+    raw_gyro[i].raw_gyro_z = (int16_t)((frame[10] << 8) + frame[11]);
+  }
+  return frames;
+}
+
+int mpu6050_fifo_drain_batch(mpu6050_fifo_clock_t *clock,
+                             const mpu6050_batch_params_t *params,
+                             const mpu6050_batch_out_t *out,
+                             uint64_t *timestamps, size_t max_frames) {
+  TRACE_BEGIN(drain);
+  uint8_t buffer[MPU6050_FIFO_SIZE];
+  uint64_t drain_ns;
+  size_t backlog;
+
+  if (max_frames > MPU6050_FIFO_SIZE / MPU6050_FIFO_FRAME_SIZE) {
+    max_frames = MPU6050_FIFO_SIZE / MPU6050_FIFO_FRAME_SIZE;
+  }
+  int frames = mpu6050_fifo_read(buffer, max_frames, &drain_ns, &backlog);
+  if (frames < 0) {
+    clock->synced = 0;
+    return frames;
+  }
+  mpu6050_fifo_timestamps(clock, drain_ns, (size_t)frames, backlog,
+                          timestamps);
+  mpu6050_batch_convert(buffer, (size_t)frames, params, out);
+  TRACE_END(drain, "mpu6050_drain_batch", frames);
+  return frames;
+}
+
+// Two register reads: take it once and reuse it for every drain until the
+// range or the calibration changes
+int mpu6050_batch_params(mpu6050_batch_params_t *params) {
+  float acce_sensitivity = mpu6050_get_acce_sensitivity();
+  float gyro_sensitivity = mpu6050_get_gyro_sensitivity();
+  if (acce_sensitivity == 0 || gyro_sensitivity == 0) {
+    return -1;
+  }
+  for (int axis = 0; axis < 3; axis++) {
+    params->bias[axis] = acce_bias[axis];
+    params->bias[axis + 3] = gyro_bias[axis];
+    params->sensitivity[axis] = acce_sensitivity;
+    params->sensitivity[axis + 3] = gyro_sensitivity;
+  }
+  return 0;
+}
+
 static int mpu6050_init(uint8_t slave) {
+  i2c_tools_use(bus);
   int ret = i2c_tools_init();
   if (ret != BCM2835_I2C_REASON_OK) {
     fprintf(stderr, "Error initializing I2C: %d\n", ret);
@@ -155,7 +506,7 @@ static int mpu6050_init(uint8_t slave) {
 
   slave_addr = slave;
   uint8_t chip_id = i2c_tool_read_byte(MPU6050_WHO_AM_I);
-  if (chip_id == 0x68) {
+  if (chip_id == MPU6050_CHIP_ID) {
     printf("Success: MPU6050 detected\n");
   } else if (chip_id == 0x58) {
     printf("Success: BMP280 detected\n");
@@ -166,12 +517,29 @@ static int mpu6050_init(uint8_t slave) {
   return 0;
 }
 
+void mpu6050_set_bus(const i2c_tools_backend_t *transport) {
+  bus = transport;
+}
+
 int mpu6050_begin(uint8_t slave) {
   if (mpu6050_init(slave) != 0) {
     fprintf(stderr, "Error initializing MPU6050\n");
     return -1;
   }
 
-  mpu6050_wake_up();
+  return mpu6050_start(slave);
+}
+
+// Wake-up only, for callers that initialized the bus and probed the chip
+// themselves; samples are valid from mpu6050_ready_ns() on
+int mpu6050_start(uint8_t slave) {
+  slave_addr = slave;
+  int ret = mpu6050_wake_up();
+  if (ret != 0) {
+    return ret;
+  }
+  ready_ns = i2c_tools_timestamp_ns() + MPU6050_STARTUP_US * 1000ULL;
   return 0;
-}
\ No newline at end of file
+}
+
+uint64_t mpu6050_ready_ns(void) { return ready_ns; }
\ No newline at end of file
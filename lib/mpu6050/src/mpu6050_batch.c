@@ -0,0 +1,203 @@
+/**
+ * @file mpu6050_batch.c
+ * @brief Batch conversion of raw FIFO frames to physical units
+ *
+ * Frames are the 12 big-endian bytes the FIFO produces (acce x, y, z, gyro
+ * x, y, z). The SIMD kernels handle four frames per iteration and leave the
+ * remainder to the scalar loop. All kernels evaluate (raw - bias) /
+ * sensitivity in single precision, the same expression mpu6050_get_acce()
+ * and mpu6050_get_gyro() use, so every kernel gives bit-identical output
+ * and matches the single-sample path. ARMv7 NEON has no vector division
+ * and divides lane by lane.
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "mpu6050.h"
+#include <trace.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define MPU6050_BATCH_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define MPU6050_BATCH_NEON 1
+#endif
+
+static inline float mpu6050_batch_axis(const uint8_t *bytes, float bias,
+                                       float sensitivity) {
+  int16_t raw = (int16_t)((bytes[0] << 8) | bytes[1]);
+  return ((float)raw - bias) / sensitivity;
+}
+
+static void mpu6050_batch_scalar_from(const uint8_t *frames, size_t first,
+                                      size_t count,
+                                      const mpu6050_batch_params_t *params,
+                                      const mpu6050_batch_out_t *out) {
+  // Locals let the compiler keep the parameters in registers across stores
+  const float *b = params->bias;
+  const float *s = params->sensitivity;
+  const float b0 = b[0], b1 = b[1], b2 = b[2], b3 = b[3], b4 = b[4], b5 = b[5];
+  const float s0 = s[0], s1 = s[1], s2 = s[2], s3 = s[3], s4 = s[4], s5 = s[5];
+  float *ax = out->acce_x, *ay = out->acce_y, *az = out->acce_z;
+  float *gx = out->gyro_x, *gy = out->gyro_y, *gz = out->gyro_z;
+  for (size_t i = first; i < count; i++) {
+    const uint8_t *frame = &frames[i * MPU6050_FIFO_FRAME_SIZE];
+    ax[i] = mpu6050_batch_axis(&frame[0], b0, s0);
+    ay[i] = mpu6050_batch_axis(&frame[2], b1, s1);
+    az[i] = mpu6050_batch_axis(&frame[4], b2, s2);
+    gx[i] = mpu6050_batch_axis(&frame[6], b3, s3);
+    gy[i] = mpu6050_batch_axis(&frame[8], b4, s4);
+    gz[i] = mpu6050_batch_axis(&frame[10], b5, s5);
+  }
+}
+
+void mpu6050_batch_convert_scalar(const uint8_t *frames, size_t count,
+                                  const mpu6050_batch_params_t *params,
+                                  const mpu6050_batch_out_t *out) {
+  mpu6050_batch_scalar_from(frames, 0, count, params, out);
+}
+
+#if defined(MPU6050_BATCH_SSE2)
+
+/**
+ * @brief Byte-swap the eight 16-bit lanes and widen them to two float4
+ */
+static inline void mpu6050_batch_sse2_load(const uint8_t *bytes, __m128 *lo,
+                                           __m128 *hi) {
+  __m128i v = _mm_loadu_si128((const __m128i *)bytes);
+  v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+  // Put each int16 in the top half of an int32, shift back to sign-extend
+  *lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16));
+  *hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16));
+}
+
+static size_t mpu6050_batch_simd(const uint8_t *frames, size_t count,
+                                 const mpu6050_batch_params_t *params,
+                                 const mpu6050_batch_out_t *out) {
+  const float *b = params->bias;
+  const float *s = params->sensitivity;
+  // Interleaved lanes repeat every three vectors: (ax ay az gx)(gy gz ax ay)
+  // (az gx gy gz)
+  const __m128 bias[3] = {_mm_setr_ps(b[0], b[1], b[2], b[3]),
+                          _mm_setr_ps(b[4], b[5], b[0], b[1]),
+                          _mm_setr_ps(b[2], b[3], b[4], b[5])};
+  const __m128 sens[3] = {_mm_setr_ps(s[0], s[1], s[2], s[3]),
+                          _mm_setr_ps(s[4], s[5], s[0], s[1]),
+                          _mm_setr_ps(s[2], s[3], s[4], s[5])};
+
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const uint8_t *bytes = &frames[i * MPU6050_FIFO_FRAME_SIZE];
+    __m128 v[6];
+    mpu6050_batch_sse2_load(bytes, &v[0], &v[1]);
+    mpu6050_batch_sse2_load(bytes + 16, &v[2], &v[3]);
+    mpu6050_batch_sse2_load(bytes + 32, &v[4], &v[5]);
+    for (int k = 0; k < 6; k++) {
+      v[k] = _mm_div_ps(_mm_sub_ps(v[k], bias[k % 3]), sens[k % 3]);
+    }
+
+    // Frames 0-1 are in v0..v2 and frames 2-3 in v3..v5, gather each axis
+    __m128 a0 = _mm_shuffle_ps(v[0], v[1], _MM_SHUFFLE(3, 2, 1, 0));
+    __m128 a1 = _mm_shuffle_ps(v[3], v[4], _MM_SHUFFLE(3, 2, 1, 0));
+    __m128 c0 = _mm_shuffle_ps(v[0], v[2], _MM_SHUFFLE(1, 0, 3, 2));
+    __m128 c1 = _mm_shuffle_ps(v[3], v[5], _MM_SHUFFLE(1, 0, 3, 2));
+    __m128 e0 = _mm_shuffle_ps(v[1], v[2], _MM_SHUFFLE(3, 2, 1, 0));
+    __m128 e1 = _mm_shuffle_ps(v[4], v[5], _MM_SHUFFLE(3, 2, 1, 0));
+    _mm_storeu_ps(&out->acce_x[i],
+                  _mm_shuffle_ps(a0, a1, _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps(&out->acce_y[i],
+                  _mm_shuffle_ps(a0, a1, _MM_SHUFFLE(3, 1, 3, 1)));
+    _mm_storeu_ps(&out->acce_z[i],
+                  _mm_shuffle_ps(c0, c1, _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps(&out->gyro_x[i],
+                  _mm_shuffle_ps(c0, c1, _MM_SHUFFLE(3, 1, 3, 1)));
+    _mm_storeu_ps(&out->gyro_y[i],
+                  _mm_shuffle_ps(e0, e1, _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps(&out->gyro_z[i],
+                  _mm_shuffle_ps(e0, e1, _MM_SHUFFLE(3, 1, 3, 1)));
+  }
+  return i;
+}
+
+#elif defined(MPU6050_BATCH_NEON)
+
+/**
+ * @brief Subtract the bias and divide by the sensitivity
+ */
+static inline float32x4_t mpu6050_batch_neon_apply(float32x4_t v, float bias,
+                                                   float sensitivity) {
+  v = vsubq_f32(v, vdupq_n_f32(bias));
+#if defined(__aarch64__)
+  return vdivq_f32(v, vdupq_n_f32(sensitivity));
+#else
+  float lanes[4];
+  vst1q_f32(lanes, v);
+  for (int k = 0; k < 4; k++) {
+    lanes[k] /= sensitivity;
+  }
+  return vld1q_f32(lanes);
+#endif
+}
+
+/**
+ * @brief Convert one axis pair (acce, gyro) of four frames
+ *
+ * The stride-3 load leaves an axis pair interleaved as a0 g0 a1 g1 ...
+ */
+static inline void mpu6050_batch_neon_pair(uint16x8_t lanes, int axis,
+                                           const mpu6050_batch_params_t *p,
+                                           float *acce, float *gyro) {
+  int16x8_t v = vreinterpretq_s16_u8(vrev16q_u8(vreinterpretq_u8_u16(lanes)));
+  float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(v)));
+  float32x4_t hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(v)));
+  float32x4x2_t split = vuzpq_f32(lo, hi);
+  vst1q_f32(acce, mpu6050_batch_neon_apply(split.val[0], p->bias[axis],
+                                           p->sensitivity[axis]));
+  vst1q_f32(gyro, mpu6050_batch_neon_apply(split.val[1], p->bias[axis + 3],
+                                           p->sensitivity[axis + 3]));
+}
+
+static size_t mpu6050_batch_simd(const uint8_t *frames, size_t count,
+                                 const mpu6050_batch_params_t *params,
+                                 const mpu6050_batch_out_t *out) {
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const uint16_t *words =
+        (const uint16_t *)(const void *)&frames[i * MPU6050_FIFO_FRAME_SIZE];
+    uint16x8x3_t lanes = vld3q_u16(words);
+    mpu6050_batch_neon_pair(lanes.val[0], 0, params, &out->acce_x[i],
+                            &out->gyro_x[i]);
+    mpu6050_batch_neon_pair(lanes.val[1], 1, params, &out->acce_y[i],
+                            &out->gyro_y[i]);
+    mpu6050_batch_neon_pair(lanes.val[2], 2, params, &out->acce_z[i],
+                            &out->gyro_z[i]);
+  }
+  return i;
+}
+
+#endif
+
+void mpu6050_batch_convert(const uint8_t *frames, size_t count,
+                           const mpu6050_batch_params_t *params,
+                           const mpu6050_batch_out_t *out) {
+  TRACE_BEGIN(convert);
+  size_t done = 0;
+#if defined(MPU6050_BATCH_SSE2) || defined(MPU6050_BATCH_NEON)
+  done = mpu6050_batch_simd(frames, count, params, out);
+#endif
+  mpu6050_batch_scalar_from(frames, done, count, params, out);
+  TRACE_END(convert, "mpu6050_batch_convert", count);
+}
+
+const char *mpu6050_batch_kernel(void) {
+#if defined(MPU6050_BATCH_SSE2)
+  return "sse2";
+#elif defined(MPU6050_BATCH_NEON)
+  return "neon";
+#else
+  return "scalar";
+#endif
+}
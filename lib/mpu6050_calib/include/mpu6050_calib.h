@@ -0,0 +1,175 @@
+/**
+ * @file mpu6050_calib.h
+ * @brief Bias calibration for the MPU6050
+ *
+ * Estimates accelerometer and gyroscope offsets from stationary samples with
+ * a streaming Welford mean/variance accumulator that stops as soon as every
+ * axis mean is known to the requested confidence. The resulting offsets can
+ * be applied through the device offset registers or subtracted by the driver
+ * on the conversion path, and saved to disk so warm starts skip the whole
+ * procedure.
+ *
+ * The device is expected to lie level with Z pointing up while calibrating.
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef MPU6050_CALIB_H
+#define MPU6050_CALIB_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "mpu6050.h"
+
+/** @brief Magic number identifying a calibration blob ("MPUC") */
+#define MPU6050_CALIB_MAGIC (0x4355504DUL)
+
+/** @brief Calibration blob format version */
+#define MPU6050_CALIB_VERSION (1)
+
+/**
+ * @brief Return codes of mpu6050_calib_add()
+ */
+enum {
+  MPU6050_CALIB_MOTION = -2,   /**< Device moved, accumulation restarted */
+  MPU6050_CALIB_TIMEOUT = -1,  /**< max_samples used up without confidence */
+  MPU6050_CALIB_PENDING = 0,   /**< More samples needed */
+  MPU6050_CALIB_CONVERGED = 1, /**< Offsets known to the requested confidence */
+};
+
+/**
+ * @brief How offsets are applied to the device
+ */
+typedef enum {
+  MPU6050_CALIB_APPLY_DRIVER = 0,   /**< Subtract in mpu6050_get_acce/gyro */
+  MPU6050_CALIB_APPLY_REGISTERS = 1 /**< Program the offset registers */
+} mpu6050_calib_apply_t;
+
+/**
+ * @brief Accumulator configuration
+ */
+typedef struct {
+  uint32_t min_samples;   /**< Samples taken before testing convergence */
+  uint32_t max_samples;   /**< Samples, motion restarts included, after
+                               which calibration gives up */
+  float acce_tolerance;   /**< Target standard error of accel means (LSB) */
+  float gyro_tolerance;   /**< Target standard error of gyro means (LSB) */
+  float max_gyro_stddev;  /**< Gyro noise above this means motion (LSB) */
+} mpu6050_calib_config_t;
+
+/**
+ * @brief Streaming mean/variance state (Welford)
+ */
+typedef struct {
+  mpu6050_calib_config_t config; /**< Active configuration */
+  uint32_t count;                /**< Samples accumulated */
+  uint32_t total;                /**< Samples since init, kept on motion */
+  double mean[6];                /**< Running means, accel XYZ then gyro XYZ */
+  double m2[6];                  /**< Sums of squared deviations */
+} mpu6050_calib_t;
+
+/**
+ * @brief Calibration result, also the on-disk blob layout
+ */
+typedef struct {
+  uint32_t magic;        /**< MPU6050_CALIB_MAGIC */
+  uint16_t version;      /**< MPU6050_CALIB_VERSION */
+  uint8_t acce_fs;       /**< mpu6050_accel_range_t the offsets refer to */
+  uint8_t gyro_fs;       /**< mpu6050_gyro_range_t the offsets refer to */
+  int16_t acce_bias[3];  /**< Accelerometer offsets (LSB) */
+  int16_t gyro_bias[3];  /**< Gyroscope offsets (LSB) */
+  uint32_t sample_count; /**< Samples the offsets were estimated from */
+  uint32_t crc;          /**< CRC-32 of all preceding fields */
+} mpu6050_calib_data_t;
+
+/**
+ * @brief Fill a configuration with sensible defaults
+ * @param config Configuration to fill
+ */
+void mpu6050_calib_default_config(mpu6050_calib_config_t *config);
+
+/**
+ * @brief Reset the accumulator
+ * @param calib Accumulator state
+ * @param config Configuration, or NULL for the defaults
+ */
+void mpu6050_calib_init(mpu6050_calib_t *calib,
+                        const mpu6050_calib_config_t *config);
+
+/**
+ * @brief Add one stationary raw sample
+ * @param calib Accumulator state
+ * @param raw_acce Raw accelerometer sample
+ * @param raw_gyro Raw gyroscope sample
+ * @return One of the MPU6050_CALIB_* codes
+ */
+int mpu6050_calib_add(mpu6050_calib_t *calib,
+                      const mpu6050_raw_acce_value_t *raw_acce,
+                      const mpu6050_raw_gyro_value_t *raw_gyro);
+
+/**
+ * @brief Turn the accumulated means into offsets
+ * @param calib Accumulator state
+ * @param acce_fs Accelerometer range the samples were taken with
+ * @param gyro_fs Gyroscope range the samples were taken with
+ * @param data Destination calibration
+ */
+void mpu6050_calib_result(const mpu6050_calib_t *calib,
+                          mpu6050_accel_range_t acce_fs,
+                          mpu6050_gyro_range_t gyro_fs,
+                          mpu6050_calib_data_t *data);
+
+/**
+ * @brief Sample the device until the offsets converge
+ *
+ * Offset registers adjusted earlier by this process are restored to their
+ * factory values first, so the result is the full bias in either mode.
+ *
+ * A device that keeps moving restarts the accumulation every time, so the
+ * run gives up once max_samples samples have been read in total.
+ *
+ * @param config Configuration, or NULL for the defaults
+ * @param data Destination calibration
+ * @return 0 on success, MPU6050_CALIB_MOTION if the device was still moving
+ * when max_samples ran out, MPU6050_CALIB_TIMEOUT if it was still but the
+ * offsets did not converge, -1 on error
+ */
+int mpu6050_calib_run(const mpu6050_calib_config_t *config,
+                      mpu6050_calib_data_t *data);
+
+/**
+ * @brief Apply offsets to the device
+ *
+ * Replaces any previous calibration: registers mode writes the factory
+ * offsets minus the bias, driver mode restores the factory offsets.
+ *
+ * @param data Calibration to apply
+ * @param mode Driver subtraction or offset registers
+ * @return 0 on success, negative value on error
+ */
+int mpu6050_calib_apply(const mpu6050_calib_data_t *data,
+                        mpu6050_calib_apply_t mode);
+
+/**
+ * @brief Save a calibration blob, atomically replacing any previous one
+ * @param path File path
+ * @param data Calibration to save
+ * @return 0 on success, negative value on error
+ */
+int mpu6050_calib_save(const char *path, const mpu6050_calib_data_t *data);
+
+/**
+ * @brief Load and validate a calibration blob
+ * @param path File path
+ * @param data Destination calibration
+ * @return 0 on success, negative value if missing or corrupt
+ */
+int mpu6050_calib_load(const char *path, mpu6050_calib_data_t *data);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // MPU6050_CALIB_H
@@ -0,0 +1,286 @@
+/**
+ * @file mpu6050_calib.c
+ * @brief Implementation of the MPU6050 bias calibration
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <math.h>
+#include <mpu6050_calib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+/** @brief Samples taken before the motion check becomes meaningful */
+#define MPU6050_CALIB_MOTION_WARMUP (32)
+
+/** @brief Accelerometer sensitivity (LSB/g) for a given range */
+static float mpu6050_calib_acce_lsb(int acce_fs) {
+  return 16384.0f / (float)(1 << acce_fs);
+}
+
+/** @brief Gyroscope sensitivity (LSB/(deg/s)) for a given range */
+static float mpu6050_calib_gyro_lsb(int gyro_fs) {
+  static const float sensitivity[] = {131.0f, 65.5f, 32.8f, 16.4f};
+  return sensitivity[gyro_fs & 0x03];
+}
+
+static int16_t mpu6050_calib_round(double value) {
+  if (value > INT16_MAX) {
+    return INT16_MAX;
+  }
+  if (value < INT16_MIN) {
+    return INT16_MIN;
+  }
+  return (int16_t)lround(value);
+}
+
+/**
+ * @brief CRC-32 (IEEE 802.3, reflected) over a byte buffer
+ */
+static uint32_t mpu6050_calib_crc32(const void *data, size_t length) {
+  const uint8_t *bytes = (const uint8_t *)data;
+  uint32_t crc = 0xFFFFFFFFUL;
+  for (size_t i = 0; i < length; i++) {
+    crc ^= bytes[i];
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ (0xEDB88320UL & (0U - (crc & 1U)));
+    }
+  }
+  return ~crc;
+}
+
+void mpu6050_calib_default_config(mpu6050_calib_config_t *config) {
+  config->min_samples = 100;
+  config->max_samples = 5000;
+  config->acce_tolerance = 4.0f;
+  config->gyro_tolerance = 1.0f;
+  config->max_gyro_stddev = 30.0f;
+}
+
+/**
+ * @brief Drop the accumulated statistics, keeping the sample budget
+ */
+static void mpu6050_calib_restart(mpu6050_calib_t *calib) {
+  calib->count = 0;
+  memset(calib->mean, 0, sizeof(calib->mean));
+  memset(calib->m2, 0, sizeof(calib->m2));
+}
+
+/**
+ * @brief PENDING, or the reason for giving up once the sample budget is used
+ * up: MOTION if it ran out before motion could be ruled out again after a
+ * restart, TIMEOUT otherwise
+ */
+static int mpu6050_calib_pending(const mpu6050_calib_t *calib) {
+  if (calib->total < calib->config.max_samples) {
+    return MPU6050_CALIB_PENDING;
+  }
+  if (calib->count < MPU6050_CALIB_MOTION_WARMUP &&
+      calib->total > calib->count) {
+    return MPU6050_CALIB_MOTION;
+  }
+  return MPU6050_CALIB_TIMEOUT;
+}
+
+void mpu6050_calib_init(mpu6050_calib_t *calib,
+                        const mpu6050_calib_config_t *config) {
+  if (config != NULL) {
+    calib->config = *config;
+  } else {
+    mpu6050_calib_default_config(&calib->config);
+  }
+  calib->total = 0;
+  mpu6050_calib_restart(calib);
+}
+
+int mpu6050_calib_add(mpu6050_calib_t *calib,
+                      const mpu6050_raw_acce_value_t *raw_acce,
+                      const mpu6050_raw_gyro_value_t *raw_gyro) {
+  const double sample[6] = {
+      raw_acce->raw_acce_x, raw_acce->raw_acce_y, raw_acce->raw_acce_z,
+      raw_gyro->raw_gyro_x, raw_gyro->raw_gyro_y, raw_gyro->raw_gyro_z};
+
+  calib->total++;
+  calib->count++;
+  for (int axis = 0; axis < 6; axis++) {
+    double delta = sample[axis] - calib->mean[axis];
+    calib->mean[axis] += delta / calib->count;
+    calib->m2[axis] += delta * (sample[axis] - calib->mean[axis]);
+  }
+
+  if (calib->count < MPU6050_CALIB_MOTION_WARMUP) {
+    return mpu6050_calib_pending(calib);
+  }
+
+  // A moving device shows up as gyro variance well above the noise floor
+  double max_variance =
+      (double)calib->config.max_gyro_stddev * calib->config.max_gyro_stddev;
+  for (int axis = 3; axis < 6; axis++) {
+    if (calib->m2[axis] / (calib->count - 1) > max_variance) {
+      mpu6050_calib_restart(calib);
+      return MPU6050_CALIB_MOTION;
+    }
+  }
+
+  if (calib->count < calib->config.min_samples) {
+    return mpu6050_calib_pending(calib);
+  }
+
+  // Converged once the standard error of every mean is within tolerance
+  int converged = 1;
+  for (int axis = 0; axis < 6; axis++) {
+    double tolerance = axis < 3 ? calib->config.acce_tolerance
+                                : calib->config.gyro_tolerance;
+    double variance = calib->m2[axis] / (calib->count - 1);
+    if (variance / calib->count > tolerance * tolerance) {
+      converged = 0;
+      break;
+    }
+  }
+  if (converged) {
+    return MPU6050_CALIB_CONVERGED;
+  }
+  return mpu6050_calib_pending(calib);
+}
+
+void mpu6050_calib_result(const mpu6050_calib_t *calib,
+                          mpu6050_accel_range_t acce_fs,
+                          mpu6050_gyro_range_t gyro_fs,
+                          mpu6050_calib_data_t *data) {
+  memset(data, 0, sizeof(*data));
+  data->magic = MPU6050_CALIB_MAGIC;
+  data->version = MPU6050_CALIB_VERSION;
+  data->acce_fs = (uint8_t)acce_fs;
+  data->gyro_fs = (uint8_t)gyro_fs;
+  data->sample_count = calib->count;
+
+  for (int axis = 0; axis < 3; axis++) {
+    data->acce_bias[axis] = mpu6050_calib_round(calib->mean[axis]);
+    data->gyro_bias[axis] = mpu6050_calib_round(calib->mean[axis + 3]);
+  }
+  // Z sees +1 g when level, that part is not bias
+  data->acce_bias[2] = mpu6050_calib_round(calib->mean[2] -
+                                           mpu6050_calib_acce_lsb(acce_fs));
+  data->crc = mpu6050_calib_crc32(data, offsetof(mpu6050_calib_data_t, crc));
+}
+
+int mpu6050_calib_run(const mpu6050_calib_config_t *config,
+                      mpu6050_calib_data_t *data) {
+  mpu6050_calib_t calib;
+  mpu6050_raw_acce_value_t raw_acce;
+  mpu6050_raw_gyro_value_t raw_gyro;
+
+  mpu6050_calib_init(&calib, config);
+  // Measure against the factory offsets, not a previous adjustment
+  if (mpu6050_restore_offset_registers() != 0) {
+    return -1;
+  }
+  mpu6050_accel_range_t acce_fs = mpu6050_get_acce_fs();
+  mpu6050_gyro_range_t gyro_fs = mpu6050_get_gyro_fs();
+
+  // Wait one output period between reads so no sample is counted twice
+  uint32_t period_us = (uint32_t)(1e6f / mpu6050_get_sample_rate());
+
+  int ret = MPU6050_CALIB_PENDING;
+  while (ret != MPU6050_CALIB_CONVERGED) {
+    mpu6050_get_raw_acce(&raw_acce);
+    mpu6050_get_raw_gyro(&raw_gyro);
+    ret = mpu6050_calib_add(&calib, &raw_acce, &raw_gyro);
+    if (ret == MPU6050_CALIB_MOTION &&
+        calib.total >= calib.config.max_samples) {
+      fprintf(stderr,
+              "Error calibrating MPU6050: still moving after %u samples\n",
+              calib.total);
+      return ret;
+    }
+    if (ret == MPU6050_CALIB_TIMEOUT) {
+      fprintf(stderr,
+              "Error calibrating MPU6050: no convergence after %u samples\n",
+              calib.total);
+      return ret;
+    }
+    i2c_tools_delay_us(period_us);
+  }
+
+  mpu6050_calib_result(&calib, acce_fs, gyro_fs, data);
+  return 0;
+}
+
+int mpu6050_calib_apply(const mpu6050_calib_data_t *data,
+                        mpu6050_calib_apply_t mode) {
+  int16_t acce_bias[3];
+  int16_t gyro_bias[3];
+
+  // Rescale in case the ranges changed since the offsets were estimated
+  float acce_scale = mpu6050_calib_acce_lsb(mpu6050_get_acce_fs()) /
+                     mpu6050_calib_acce_lsb(data->acce_fs);
+  float gyro_scale = mpu6050_calib_gyro_lsb(mpu6050_get_gyro_fs()) /
+                     mpu6050_calib_gyro_lsb(data->gyro_fs);
+  for (int axis = 0; axis < 3; axis++) {
+    acce_bias[axis] = mpu6050_calib_round(data->acce_bias[axis] * acce_scale);
+    gyro_bias[axis] = mpu6050_calib_round(data->gyro_bias[axis] * gyro_scale);
+  }
+
+  if (mode == MPU6050_CALIB_APPLY_REGISTERS) {
+    const int16_t none[3] = {0, 0, 0};
+    mpu6050_set_acce_bias(none);
+    mpu6050_set_gyro_bias(none);
+    return mpu6050_adjust_offset_registers(acce_bias, gyro_bias);
+  }
+
+  mpu6050_set_acce_bias(acce_bias);
+  mpu6050_set_gyro_bias(gyro_bias);
+  return mpu6050_restore_offset_registers();
+}
+
+int mpu6050_calib_save(const char *path, const mpu6050_calib_data_t *data) {
+  char tmp_path[4096];
+  if (snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path) >=
+      (int)sizeof(tmp_path)) {
+    return -1;
+  }
+
+  FILE *file = fopen(tmp_path, "wb");
+  if (file == NULL) {
+    fprintf(stderr, "Error opening %s for writing\n", tmp_path);
+    return -1;
+  }
+  mpu6050_calib_data_t blob = *data;
+  blob.crc = mpu6050_calib_crc32(&blob, offsetof(mpu6050_calib_data_t, crc));
+  size_t written = fwrite(&blob, sizeof(blob), 1, file);
+  if (written != 1 || fflush(file) != 0 || fsync(fileno(file)) != 0) {
+    fclose(file);
+    unlink(tmp_path);
+    return -1;
+  }
+  fclose(file);
+
+  // rename() is atomic, a crash leaves either the old or the new blob
+  if (rename(tmp_path, path) != 0) {
+    unlink(tmp_path);
+    return -1;
+  }
+  return 0;
+}
+
+int mpu6050_calib_load(const char *path, mpu6050_calib_data_t *data) {
+  FILE *file = fopen(path, "rb");
+  if (file == NULL) {
+    return -1;
+  }
+  size_t read = fread(data, sizeof(*data), 1, file);
+  fclose(file);
+  if (read != 1) {
+    return -2;
+  }
+  if (data->magic != MPU6050_CALIB_MAGIC ||
+      data->version != MPU6050_CALIB_VERSION ||
+      data->crc !=
+          mpu6050_calib_crc32(data, offsetof(mpu6050_calib_data_t, crc))) {
+    return -2;
+  }
+  return 0;
+}
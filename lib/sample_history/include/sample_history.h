@@ -0,0 +1,176 @@
+/**
+ * @file sample_history.h
+ * @brief Fixed-capacity, time-indexed sample history with range queries
+ *
+ * One history holds the last capacity samples of a stream whose channels
+ * share timestamps (the six IMU axes, or the three BME280 outputs). The
+ * timestamps and every channel are separate rings (structure of arrays),
+ * all carved out of one allocation made at init, so memory use is fixed:
+ * capacity * (8 + 4 * channels) bytes plus the struct. The capacity is
+ * used as given, not rounded: ten minutes of IMU data at 1 kHz is 600,000
+ * samples of 32 bytes, 19.2 MB.
+ *
+ * Timestamps must not decrease, which makes the timestamp ring its own
+ * index: a range lookup is two binary searches and returns a view, pointers
+ * straight into the rings split in at most two segments where the range
+ * wraps around. Nothing is copied.
+ *
+ * One thread pushes. Readers on other threads may query concurrently under
+ * a seqlock-style contract: the rings are plain memory, so a reader can
+ * load a slot while the writer, having lapped the view, overwrites it.
+ * Under the C11 memory model that is a data race and the values read may
+ * be torn. The writer retires a slot (advances start, release fence)
+ * before overwriting it, so a reader that consumed a view and then gets 1
+ * from sample_history_valid() read only intact samples; on 0 it discards
+ * everything read from the view. Readers must not act on the data before
+ * that check. The binary searches of sample_history_range() follow the
+ * same rule internally and repeat when the writer moved past them.
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef SAMPLE_HISTORY_H
+#define SAMPLE_HISTORY_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "bme280.h"
+#include "mpu6050.h"
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** @brief Maximum channels per history */
+#define SAMPLE_HISTORY_MAX_CHANNELS (8)
+
+/** @brief Channels of an IMU history: acce x, y, z, gyro x, y, z */
+#define SAMPLE_HISTORY_IMU_CHANNELS (6)
+
+/** @brief Channels of an environment history: temperature, pressure,
+ * humidity */
+#define SAMPLE_HISTORY_ENV_CHANNELS (3)
+
+/**
+ * @brief History state
+ */
+typedef struct {
+  size_t channels;                           /**< Channels per sample */
+  size_t capacity;                           /**< Samples kept */
+  size_t slot;                               /**< Next slot (writer) */
+  uint64_t last_ns;                          /**< Newest timestamp (writer) */
+  uint64_t *times;                           /**< Timestamp ring (ns) */
+  float *values[SAMPLE_HISTORY_MAX_CHANNELS]; /**< One ring per channel */
+  _Atomic uint64_t start;                    /**< Oldest retained sample */
+  _Atomic uint64_t head;                     /**< Samples ever pushed */
+  void *memory;                              /**< Backing allocation */
+} sample_history_t;
+
+/**
+ * @brief Zero-copy view of consecutive samples
+ *
+ * Segment 0 holds the older samples, segment 1 the continuation after the
+ * ring wrapped (length 0 if it did not).
+ */
+typedef struct {
+  uint64_t first;   /**< Sequence number of the first sample */
+  size_t count;     /**< Samples in the view */
+  size_t length[2]; /**< Samples per segment */
+  const uint64_t *times[2]; /**< Timestamps per segment */
+  const float *values[SAMPLE_HISTORY_MAX_CHANNELS][2]; /**< Channel data */
+} sample_history_view_t;
+
+/**
+ * @brief Bytes a history of this size allocates
+ * @param channels Channels per sample
+ * @param capacity Samples
+ * @return Allocation size
+ */
+size_t sample_history_memory(size_t channels, size_t capacity);
+
+/**
+ * @brief Allocate a history
+ * @param history History
+ * @param channels Channels per sample, 1..SAMPLE_HISTORY_MAX_CHANNELS
+ * @param capacity Samples kept
+ * @return 0 on success, -1 on invalid arguments or allocation failure
+ */
+int sample_history_init(sample_history_t *history, size_t channels,
+                        size_t capacity);
+
+/**
+ * @brief Append a sample, evicting the oldest when full
+ * @param history History
+ * @param timestamp_ns Sample time, not older than the previous sample
+ * @param values One value per channel
+ * @return 0 on success, -1 if the timestamp goes backwards
+ */
+int sample_history_push(sample_history_t *history, uint64_t timestamp_ns,
+                        const float *values);
+
+/**
+ * @brief Append an IMU sample (acce and gyro share the read timestamp)
+ * @param history History with SAMPLE_HISTORY_IMU_CHANNELS channels
+ * @param acce Accelerometer sample, its timestamp is used
+ * @param gyro Gyroscope sample
+ * @return 0 on success, -1 if the timestamp goes backwards
+ */
+int sample_history_push_imu(sample_history_t *history,
+                            const mpu6050_acce_value_t *acce,
+                            const mpu6050_gyro_value_t *gyro);
+
+/**
+ * @brief Append an environment sample
+ * @param history History with SAMPLE_HISTORY_ENV_CHANNELS channels
+ * @param env BME280 sample
+ * @return 0 on success, -1 if the timestamp goes backwards
+ */
+int sample_history_push_env(sample_history_t *history,
+                            const bme280_sample_t *env);
+
+/**
+ * @brief Samples with from_ns <= timestamp <= to_ns, O(log n)
+ * @param history History
+ * @param from_ns Start of the range
+ * @param to_ns End of the range, inclusive
+ * @param view Destination, count 0 if nothing matches
+ * @return Number of samples in the view
+ */
+size_t sample_history_range(sample_history_t *history, uint64_t from_ns,
+                            uint64_t to_ns, sample_history_view_t *view);
+
+/**
+ * @brief The newest samples
+ * @param history History
+ * @param count Samples wanted, fewer if the history holds fewer
+ * @param view Destination
+ * @return Number of samples in the view
+ */
+size_t sample_history_latest(sample_history_t *history, size_t count,
+                             sample_history_view_t *view);
+
+/**
+ * @brief Whether the writer has not overwritten a view yet
+ *
+ * Call after reading the view data and before using it; if it returns 0
+ * part of what was read may belong to newer samples or be torn.
+ *
+ * @param history History
+ * @param view View from this history
+ * @return 1 if the data read was intact, 0 otherwise
+ */
+int sample_history_valid(sample_history_t *history,
+                         const sample_history_view_t *view);
+
+/**
+ * @brief Release the history memory
+ * @param history History
+ */
+void sample_history_free(sample_history_t *history);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // SAMPLE_HISTORY_H
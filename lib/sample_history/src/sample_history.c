@@ -0,0 +1,178 @@
+/**
+ * @file sample_history.c
+ * @brief Structure-of-arrays rings and timestamp binary search
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <sample_history.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+size_t sample_history_memory(size_t channels, size_t capacity) {
+  return capacity * (sizeof(uint64_t) + channels * sizeof(float));
+}
+
+int sample_history_init(sample_history_t *history, size_t channels,
+                        size_t capacity) {
+  memset(history, 0, sizeof(*history));
+  if (channels == 0 || channels > SAMPLE_HISTORY_MAX_CHANNELS ||
+      capacity == 0) {
+    return -1;
+  }
+
+  // Timestamps first so every channel ring stays 8-byte aligned
+  history->memory = malloc(sample_history_memory(channels, capacity));
+  if (history->memory == NULL) {
+    fprintf(stderr, "Error allocating a history of %zu samples\n", capacity);
+    return -1;
+  }
+  history->channels = channels;
+  history->capacity = capacity;
+  history->times = (uint64_t *)history->memory;
+  float *values = (float *)(history->times + capacity);
+  for (size_t ch = 0; ch < channels; ch++) {
+    history->values[ch] = values + ch * capacity;
+  }
+  atomic_init(&history->start, 0);
+  atomic_init(&history->head, 0);
+  return 0;
+}
+
+int sample_history_push(sample_history_t *history, uint64_t timestamp_ns,
+                        const float *values) {
+  uint64_t head = atomic_load_explicit(&history->head, memory_order_relaxed);
+  size_t slot = history->slot;
+  if (head > 0 && timestamp_ns < history->last_ns) {
+    return -1;
+  }
+
+  if (head >= history->capacity) {
+    // Retire the slot before overwriting it, so a reader that then sees
+    // any of the new data also sees the new start in sample_history_valid()
+    atomic_store_explicit(&history->start, head - history->capacity + 1,
+                          memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+  }
+  history->times[slot] = timestamp_ns;
+  for (size_t ch = 0; ch < history->channels; ch++) {
+    history->values[ch][slot] = values[ch];
+  }
+  // Conditional wrap instead of a modulo, the capacity is arbitrary
+  history->slot = slot + 1 == history->capacity ? 0 : slot + 1;
+  history->last_ns = timestamp_ns;
+  atomic_store_explicit(&history->head, head + 1, memory_order_release);
+  return 0;
+}
+
+int sample_history_push_imu(sample_history_t *history,
+                            const mpu6050_acce_value_t *acce,
+                            const mpu6050_gyro_value_t *gyro) {
+  const float values[SAMPLE_HISTORY_IMU_CHANNELS] = {
+      acce->acce_x, acce->acce_y, acce->acce_z,
+      gyro->gyro_x, gyro->gyro_y, gyro->gyro_z};
+  return sample_history_push(history, acce->timestamp_ns, values);
+}
+
+int sample_history_push_env(sample_history_t *history,
+                            const bme280_sample_t *env) {
+  const float values[SAMPLE_HISTORY_ENV_CHANNELS] = {
+      env->temperature, env->pressure, env->humidity};
+  return sample_history_push(history, env->timestamp_ns, values);
+}
+
+/**
+ * @brief Fill the segments of the sequence numbers [first, first + count)
+ */
+static size_t sample_history_view(const sample_history_t *history,
+                                  uint64_t first, size_t count,
+                                  sample_history_view_t *view) {
+  memset(view, 0, sizeof(*view));
+  view->first = first;
+  view->count = count;
+  if (count == 0) {
+    return 0;
+  }
+  size_t capacity = history->capacity;
+  size_t offset = (size_t)(first % capacity);
+  view->length[0] = count < capacity - offset ? count : capacity - offset;
+  view->length[1] = count - view->length[0];
+  view->times[0] = history->times + offset;
+  view->times[1] = history->times;
+  for (size_t ch = 0; ch < history->channels; ch++) {
+    view->values[ch][0] = history->values[ch] + offset;
+    view->values[ch][1] = history->values[ch];
+  }
+  return count;
+}
+
+/**
+ * @brief First sequence number in [lo, hi) whose timestamp is above
+ * timestamp_ns (or not below it when inclusive), hi if none
+ */
+static uint64_t sample_history_search(const sample_history_t *history,
+                                      uint64_t lo, uint64_t hi,
+                                      uint64_t timestamp_ns, int inclusive) {
+  while (lo < hi) {
+    uint64_t mid = lo + (hi - lo) / 2;
+    uint64_t ts = history->times[mid % history->capacity];
+    if (ts < timestamp_ns || (!inclusive && ts == timestamp_ns)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+size_t sample_history_range(sample_history_t *history, uint64_t from_ns,
+                            uint64_t to_ns, sample_history_view_t *view) {
+  uint64_t head = atomic_load_explicit(&history->head, memory_order_acquire);
+  uint64_t start = atomic_load_explicit(&history->start, memory_order_relaxed);
+  if (from_ns > to_ns || head == start) {
+    return sample_history_view(history, head, 0, view);
+  }
+  for (;;) {
+    uint64_t first = sample_history_search(history, start, head, from_ns, 1);
+    uint64_t last = sample_history_search(history, first, head, to_ns, 0);
+    // The searches read slots down to start; if the writer retired any of
+    // them meanwhile the bounds may come from torn timestamps, so search
+    // again over what is still retained
+    atomic_thread_fence(memory_order_acquire);
+    uint64_t retired =
+        atomic_load_explicit(&history->start, memory_order_relaxed);
+    if (retired <= start) {
+      return sample_history_view(history, first, (size_t)(last - first),
+                                 view);
+    }
+    start = retired;
+    if (start >= head) {
+      return sample_history_view(history, head, 0, view);
+    }
+  }
+}
+
+size_t sample_history_latest(sample_history_t *history, size_t count,
+                             sample_history_view_t *view) {
+  uint64_t head = atomic_load_explicit(&history->head, memory_order_acquire);
+  uint64_t start = atomic_load_explicit(&history->start, memory_order_relaxed);
+  if (count > head - start) {
+    count = (size_t)(head - start);
+  }
+  return sample_history_view(history, head - count, count, view);
+}
+
+int sample_history_valid(sample_history_t *history,
+                         const sample_history_view_t *view) {
+  atomic_thread_fence(memory_order_acquire);
+  return atomic_load_explicit(&history->start, memory_order_relaxed) <=
+         view->first;
+}
+
+void sample_history_free(sample_history_t *history) {
+  free(history->memory);
+  memset(history, 0, sizeof(*history));
+}
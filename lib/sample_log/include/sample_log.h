@@ -0,0 +1,214 @@
+/**
+ * @file sample_log.h
+ * @brief Append-only, memory-mapped binary sample log
+ *
+ * Records are appended into preallocated segment files mapped in memory, so
+ * logging a sample is a handful of stores with no system call. Each segment
+ * starts with a header page holding the committed length and a sparse
+ * timestamp index, followed by the record area.
+ *
+ * Record schema (fixed):
+ *   - tag byte: 0x80 marker, bit 2 keyframe, bits 0-1 stream
+ *   - timestamp: absolute varint on keyframes, zigzag delta varint otherwise
+ *   - IMU stream: raw accel XYZ and gyro XYZ (LSB)
+ *   - ENV stream: temperature (0.01 °C), pressure (0.01 Pa),
+ *     humidity (0.001 %)
+ *   - channels: absolute zigzag varints on keyframes, deltas against the
+ *     previous record of the same stream otherwise
+ *
+ * Crash safety: the committed length only covers fully written records and
+ * is published with release ordering. Preallocated space reads back as zero,
+ * which is never a valid tag, so readers stop at torn or unwritten data even
+ * if the header page reached disk before the records did.
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef SAMPLE_LOG_H
+#define SAMPLE_LOG_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "bme280.h"
+#include "mpu6050.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/** @brief Segment file magic ("SLOG") */
+#define SAMPLE_LOG_MAGIC (0x474F4C53UL)
+
+/** @brief Segment format version */
+#define SAMPLE_LOG_VERSION (1)
+
+/** @brief Bytes reserved at the start of a segment for header and index */
+#define SAMPLE_LOG_HEADER_SIZE (65536)
+
+/** @brief Largest encoded record */
+#define SAMPLE_LOG_MAX_RECORD (48)
+
+/** @brief Longest segment path */
+#define SAMPLE_LOG_PATH_MAX (512)
+
+/**
+ * @brief Record streams
+ */
+typedef enum {
+  SAMPLE_LOG_IMU = 0, /**< MPU6050 raw accel + gyro */
+  SAMPLE_LOG_ENV = 1, /**< BME280 temperature, pressure, humidity */
+  SAMPLE_LOG_STREAMS
+} sample_log_stream_t;
+
+/**
+ * @brief Writer configuration
+ */
+typedef struct {
+  const char *directory;      /**< Directory holding the segments */
+  const char *prefix;         /**< Segment file name prefix */
+  size_t segment_size;        /**< Bytes per segment, header included */
+  uint16_t keyframe_interval; /**< Records per stream between keyframes */
+  uint32_t sync_interval;     /**< Records between msync(), 0 to disable */
+} sample_log_config_t;
+
+/**
+ * @brief Writer state
+ */
+typedef struct {
+  sample_log_config_t config;         /**< Active configuration */
+  char directory[SAMPLE_LOG_PATH_MAX]; /**< Copy of the directory */
+  char prefix[64];                    /**< Copy of the prefix */
+  int fd;                             /**< Open segment */
+  uint8_t *map;                       /**< Mapped segment */
+  uint64_t segment;                   /**< Segment number */
+  size_t used;                        /**< Record bytes written */
+  size_t next_index_at;               /**< Offset of the next index entry */
+  size_t index_stride;                /**< Bytes between index entries */
+  int32_t last[SAMPLE_LOG_STREAMS][6];   /**< Previous values per stream */
+  uint64_t last_ns[SAMPLE_LOG_STREAMS];  /**< Previous time per stream */
+  uint16_t since_key[SAMPLE_LOG_STREAMS]; /**< Records since a keyframe */
+  int force_key[SAMPLE_LOG_STREAMS];      /**< Next record must be a key */
+  uint32_t since_sync;                /**< Records since the last msync */
+} sample_log_t;
+
+/**
+ * @brief Decoded record
+ */
+typedef struct {
+  sample_log_stream_t stream; /**< Which fields are valid */
+  uint64_t timestamp_ns;      /**< Sample time */
+  mpu6050_raw_acce_value_t raw_acce; /**< IMU stream only */
+  mpu6050_raw_gyro_value_t raw_gyro; /**< IMU stream only */
+  bme280_sample_t env;               /**< ENV stream only */
+} sample_log_record_t;
+
+/**
+ * @brief Reader state
+ */
+typedef struct {
+  char directory[SAMPLE_LOG_PATH_MAX]; /**< Directory holding the segments */
+  char prefix[64];                     /**< Segment file name prefix */
+  uint64_t *segments;                  /**< Sorted segment numbers */
+  size_t segment_count;                /**< Entries in segments */
+  size_t current;                      /**< Position in segments */
+  int fd;                              /**< Open segment */
+  const uint8_t *map;                  /**< Mapped segment */
+  size_t map_size;                     /**< Mapped bytes */
+  size_t offset;                       /**< Read position in the records */
+  int32_t last[SAMPLE_LOG_STREAMS][6]; /**< Previous values per stream */
+  uint64_t last_ns[SAMPLE_LOG_STREAMS]; /**< Previous time per stream */
+  int known[SAMPLE_LOG_STREAMS];       /**< Stream state is valid */
+} sample_log_reader_t;
+
+/**
+ * @brief Fill a configuration with sensible defaults
+ * @param config Configuration to fill
+ * @param directory Directory holding the segments
+ * @param prefix Segment file name prefix
+ */
+void sample_log_default_config(sample_log_config_t *config,
+                               const char *directory, const char *prefix);
+
+/**
+ * @brief Start a new segment after any existing ones
+ * @param log Writer state
+ * @param config Writer configuration
+ * @return 0 on success, negative value on error
+ */
+int sample_log_open(sample_log_t *log, const sample_log_config_t *config);
+
+/**
+ * @brief Append an MPU6050 sample
+ * @param log Writer state
+ * @param raw_acce Raw accelerometer sample, its timestamp is logged
+ * @param raw_gyro Raw gyroscope sample
+ * @return 0 on success, negative value on error
+ */
+int sample_log_append_imu(sample_log_t *log,
+                          const mpu6050_raw_acce_value_t *raw_acce,
+                          const mpu6050_raw_gyro_value_t *raw_gyro);
+
+/**
+ * @brief Append a BME280 sample
+ * @param log Writer state
+ * @param sample BME280 sample
+ * @return 0 on success, negative value on error
+ */
+int sample_log_append_env(sample_log_t *log, const bme280_sample_t *sample);
+
+/**
+ * @brief Flush written records and the header to storage
+ * @param log Writer state
+ * @return 0 on success, negative value on error
+ */
+int sample_log_sync(sample_log_t *log);
+
+/**
+ * @brief Sync, trim the open segment to its used size and close it
+ * @param log Writer state
+ */
+void sample_log_close(sample_log_t *log);
+
+/**
+ * @brief Open all segments of a log for reading, positioned at the start
+ * @param reader Reader state
+ * @param directory Directory holding the segments
+ * @param prefix Segment file name prefix
+ * @return 0 on success, negative value on error
+ */
+int sample_log_reader_open(sample_log_reader_t *reader, const char *directory,
+                           const char *prefix);
+
+/**
+ * @brief Position the reader at the first record at or after a time
+ * @param reader Reader state
+ * @param timestamp_ns Time to seek to
+ * @return 0 on success, negative value on error
+ */
+int sample_log_reader_seek(sample_log_reader_t *reader, uint64_t timestamp_ns);
+
+/**
+ * @brief Read the next record
+ *
+ * At the end of the newest segment the directory is listed again, so a
+ * reader following a live log moves on to the segments the writer
+ * rotates into; call again later after 0 to keep tailing.
+ *
+ * @param reader Reader state
+ * @param record Destination record
+ * @return 1 if a record was read, 0 at the end of the log, negative on error
+ */
+int sample_log_reader_next(sample_log_reader_t *reader,
+                           sample_log_record_t *record);
+
+/**
+ * @brief Release the reader
+ * @param reader Reader state
+ */
+void sample_log_reader_close(sample_log_reader_t *reader);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // SAMPLE_LOG_H
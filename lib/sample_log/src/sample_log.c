@@ -0,0 +1,294 @@
+/**
+ * @file sample_log.c
+ * @brief Sample log writer
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "sample_log_internal.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+int sample_log_segment_path(char *path, size_t size, const char *directory,
+                            const char *prefix, uint64_t segment) {
+  int length = snprintf(path, size, "%s/%s-%08" PRIu64 ".slog", directory,
+                        prefix, segment);
+  return length >= 0 && (size_t)length < size ? 0 : -1;
+}
+
+static int sample_log_compare(const void *a, const void *b) {
+  uint64_t x = *(const uint64_t *)a;
+  uint64_t y = *(const uint64_t *)b;
+  return (x > y) - (x < y);
+}
+
+int sample_log_list_segments(const char *directory, const char *prefix,
+                             uint64_t **segments) {
+  DIR *dir = opendir(directory);
+  if (dir == NULL) {
+    return -1;
+  }
+
+  size_t count = 0;
+  size_t capacity = 16;
+  uint64_t *list = malloc(capacity * sizeof(*list));
+  if (list == NULL) {
+    closedir(dir);
+    return -1;
+  }
+
+  size_t prefix_length = strlen(prefix);
+  struct dirent *entry;
+  while ((entry = readdir(dir)) != NULL) {
+    const char *name = entry->d_name;
+    if (strncmp(name, prefix, prefix_length) != 0 ||
+        name[prefix_length] != '-') {
+      continue;
+    }
+    uint64_t segment;
+    int consumed = 0;
+    if (sscanf(name + prefix_length + 1, "%" SCNu64 ".slog%n", &segment,
+               &consumed) != 1 ||
+        name[prefix_length + 1 + consumed] != '\0' || consumed == 0) {
+      continue;
+    }
+    if (count == capacity) {
+      capacity *= 2;
+      uint64_t *grown = realloc(list, capacity * sizeof(*list));
+      if (grown == NULL) {
+        free(list);
+        closedir(dir);
+        return -1;
+      }
+      list = grown;
+    }
+    list[count++] = segment;
+  }
+  closedir(dir);
+
+  qsort(list, count, sizeof(*list), sample_log_compare);
+  *segments = list;
+  return (int)count;
+}
+
+static sample_log_header_t *sample_log_header(sample_log_t *log) {
+  return (sample_log_header_t *)log->map;
+}
+
+static int sample_log_create_segment(sample_log_t *log) {
+  char path[SAMPLE_LOG_PATH_MAX];
+  if (sample_log_segment_path(path, sizeof(path), log->directory, log->prefix,
+                              log->segment) != 0) {
+    fprintf(stderr, "Error log segment path too long in %s\n", log->directory);
+    return -1;
+  }
+
+  int fd = open(path, O_RDWR | O_CREAT | O_EXCL, 0644);
+  if (fd < 0) {
+    fprintf(stderr, "Error creating log segment %s\n", path);
+    return -1;
+  }
+  // Reserve the blocks now so appends never fault on a full disk
+  if (posix_fallocate(fd, 0, (off_t)log->config.segment_size) != 0) {
+    fprintf(stderr, "Error preallocating log segment %s\n", path);
+    close(fd);
+    unlink(path);
+    return -1;
+  }
+  uint8_t *map = mmap(NULL, log->config.segment_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED, fd, 0);
+  if (map == MAP_FAILED) {
+    close(fd);
+    unlink(path);
+    return -1;
+  }
+
+  log->fd = fd;
+  log->map = map;
+  log->used = 0;
+  log->next_index_at = 0;
+  memset(log->since_key, 0, sizeof(log->since_key));
+
+  sample_log_header_t *header = sample_log_header(log);
+  header->version = SAMPLE_LOG_VERSION;
+  header->keyframe_interval = log->config.keyframe_interval;
+  header->segment = log->segment;
+  header->first_ns = 0;
+  header->last_ns = 0;
+  __atomic_store_n(&header->index_count, 0, __ATOMIC_RELEASE);
+  __atomic_store_n(&header->committed, 0, __ATOMIC_RELEASE);
+  // Stamped last: a reader that sees the magic sees the whole header
+  __atomic_store_n(&header->magic, SAMPLE_LOG_MAGIC, __ATOMIC_RELEASE);
+  return 0;
+}
+
+/**
+ * @brief Flush, trim and unmap the open segment
+ */
+static void sample_log_finish_segment(sample_log_t *log) {
+  if (log->map == NULL) {
+    return;
+  }
+  msync(log->map, SAMPLE_LOG_HEADER_SIZE + log->used, MS_SYNC);
+  munmap(log->map, log->config.segment_size);
+  if (ftruncate(log->fd, (off_t)(SAMPLE_LOG_HEADER_SIZE + log->used)) != 0) {
+    fprintf(stderr, "Warning: could not trim log segment %" PRIu64 "\n",
+            log->segment);
+  }
+  fsync(log->fd);
+  close(log->fd);
+  log->map = NULL;
+  log->fd = -1;
+}
+
+void sample_log_default_config(sample_log_config_t *config,
+                               const char *directory, const char *prefix) {
+  config->directory = directory;
+  config->prefix = prefix;
+  config->segment_size = 64UL * 1024 * 1024;
+  config->keyframe_interval = 256;
+  config->sync_interval = 0;
+}
+
+int sample_log_open(sample_log_t *log, const sample_log_config_t *config) {
+  memset(log, 0, sizeof(*log));
+  log->config = *config;
+  log->fd = -1;
+  if (config->segment_size <= SAMPLE_LOG_HEADER_SIZE + SAMPLE_LOG_MAX_RECORD ||
+      config->keyframe_interval == 0 ||
+      strlen(config->prefix) >= sizeof(log->prefix) ||
+      strlen(config->directory) >= sizeof(log->directory)) {
+    return -1;
+  }
+  strcpy(log->directory, config->directory);
+  strcpy(log->prefix, config->prefix);
+
+  // Whole pages only, so msync() ranges never run past the mapping
+  size_t page = (size_t)sysconf(_SC_PAGESIZE);
+  log->config.segment_size = (config->segment_size + page - 1) & ~(page - 1);
+
+  size_t data_size = log->config.segment_size - SAMPLE_LOG_HEADER_SIZE;
+  log->index_stride = data_size / SAMPLE_LOG_INDEX_CAPACITY;
+
+  uint64_t *segments;
+  int count = sample_log_list_segments(log->directory, log->prefix, &segments);
+  if (count < 0) {
+    fprintf(stderr, "Error listing log directory %s\n", log->directory);
+    return -1;
+  }
+  log->segment = count > 0 ? segments[count - 1] + 1 : 0;
+  free(segments);
+
+  return sample_log_create_segment(log);
+}
+
+static int sample_log_append(sample_log_t *log, sample_log_stream_t stream,
+                             uint64_t timestamp_ns, const int32_t *values) {
+  size_t data_size = log->config.segment_size - SAMPLE_LOG_HEADER_SIZE;
+  if (log->used + SAMPLE_LOG_MAX_RECORD > data_size) {
+    sample_log_finish_segment(log);
+    log->segment++;
+    if (sample_log_create_segment(log) != 0) {
+      return -1;
+    }
+  }
+  sample_log_header_t *header = sample_log_header(log);
+
+  // Index points restart every stream so a reader can start decoding there
+  int indexed = 0;
+  uint32_t index_count = header->index_count;
+  if (log->used >= log->next_index_at &&
+      index_count < SAMPLE_LOG_INDEX_CAPACITY) {
+    indexed = 1;
+    for (int s = 0; s < SAMPLE_LOG_STREAMS; s++) {
+      log->force_key[s] = 1;
+    }
+  }
+  int key = log->force_key[stream] || log->since_key[stream] == 0;
+
+  uint8_t *start = log->map + SAMPLE_LOG_HEADER_SIZE + log->used;
+  uint8_t *out = start;
+  int channels = sample_log_channels(stream);
+  *out++ = (uint8_t)(SAMPLE_LOG_TAG_MARKER |
+                     (key ? SAMPLE_LOG_TAG_KEYFRAME : 0) | stream);
+  if (key) {
+    out = sample_log_put_varint(out, timestamp_ns);
+    for (int c = 0; c < channels; c++) {
+      out = sample_log_put_varint(out, sample_log_zigzag32(values[c]));
+    }
+  } else {
+    int64_t delta = (int64_t)(timestamp_ns - log->last_ns[stream]);
+    out = sample_log_put_varint(out, sample_log_zigzag64(delta));
+    for (int c = 0; c < channels; c++) {
+      out = sample_log_put_varint(
+          out, sample_log_zigzag32(values[c] - log->last[stream][c]));
+    }
+  }
+
+  if (indexed) {
+    sample_log_index_entry_t *index =
+        (sample_log_index_entry_t *)(log->map + SAMPLE_LOG_INDEX_OFFSET);
+    index[index_count].timestamp_ns = timestamp_ns;
+    index[index_count].offset = log->used;
+    __atomic_store_n(&header->index_count, index_count + 1, __ATOMIC_RELEASE);
+    log->next_index_at = log->used + log->index_stride;
+  }
+  if (log->used == 0) {
+    header->first_ns = timestamp_ns;
+  }
+  header->last_ns = timestamp_ns;
+  log->used += (size_t)(out - start);
+  __atomic_store_n(&header->committed, (uint64_t)log->used, __ATOMIC_RELEASE);
+
+  memcpy(log->last[stream], values, (size_t)channels * sizeof(int32_t));
+  log->last_ns[stream] = timestamp_ns;
+  log->force_key[stream] = 0;
+  uint16_t since_key = key ? 0 : log->since_key[stream];
+  log->since_key[stream] =
+      (uint16_t)((since_key + 1) % log->config.keyframe_interval);
+
+  if (log->config.sync_interval != 0 &&
+      ++log->since_sync >= log->config.sync_interval) {
+    return sample_log_sync(log);
+  }
+  return 0;
+}
+
+int sample_log_append_imu(sample_log_t *log,
+                          const mpu6050_raw_acce_value_t *raw_acce,
+                          const mpu6050_raw_gyro_value_t *raw_gyro) {
+  const int32_t values[6] = {
+      raw_acce->raw_acce_x, raw_acce->raw_acce_y, raw_acce->raw_acce_z,
+      raw_gyro->raw_gyro_x, raw_gyro->raw_gyro_y, raw_gyro->raw_gyro_z};
+  return sample_log_append(log, SAMPLE_LOG_IMU, raw_acce->timestamp_ns, values);
+}
+
+int sample_log_append_env(sample_log_t *log, const bme280_sample_t *sample) {
+  const int32_t values[3] = {(int32_t)lroundf(sample->temperature * 100.0f),
+                             (int32_t)lroundf(sample->pressure * 100.0f),
+                             (int32_t)lroundf(sample->humidity * 1000.0f)};
+  return sample_log_append(log, SAMPLE_LOG_ENV, sample->timestamp_ns, values);
+}
+
+int sample_log_sync(sample_log_t *log) {
+  log->since_sync = 0;
+  // Records first, then the header that declares them committed
+  size_t page = (size_t)sysconf(_SC_PAGESIZE);
+  size_t length = (log->used + page - 1) & ~(page - 1);
+  if (length > 0 &&
+      msync(log->map + SAMPLE_LOG_HEADER_SIZE, length, MS_SYNC) != 0) {
+    return -1;
+  }
+  return msync(log->map, SAMPLE_LOG_HEADER_SIZE, MS_SYNC);
+}
+
+void sample_log_close(sample_log_t *log) { sample_log_finish_segment(log); }
@@ -0,0 +1,124 @@
+/**
+ * @file sample_log_internal.h
+ * @brief On-disk layout and varint helpers shared by writer and reader
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef SAMPLE_LOG_INTERNAL_H
+#define SAMPLE_LOG_INTERNAL_H
+
+#include <sample_log.h>
+
+/** @brief Tag bit present on every record, zeroed space is never a record */
+#define SAMPLE_LOG_TAG_MARKER (0x80)
+
+/** @brief Tag bit set on keyframes */
+#define SAMPLE_LOG_TAG_KEYFRAME (0x04)
+
+/** @brief Tag bits holding the stream */
+#define SAMPLE_LOG_TAG_STREAM (0x03)
+
+/** @brief Offset of the sparse index inside the header area */
+#define SAMPLE_LOG_INDEX_OFFSET (64)
+
+/** @brief Entries the sparse index can hold */
+#define SAMPLE_LOG_INDEX_CAPACITY                                              \
+  ((SAMPLE_LOG_HEADER_SIZE - SAMPLE_LOG_INDEX_OFFSET) /                        \
+   sizeof(sample_log_index_entry_t))
+
+/** @brief Reader status of a segment that exists but is not stamped yet */
+#define SAMPLE_LOG_NOT_READY (1)
+
+/**
+ * @brief Sparse index entry, points at a record where every stream restarts
+ * with a keyframe
+ */
+typedef struct {
+  uint64_t timestamp_ns; /**< Time of the record at offset */
+  uint64_t offset;       /**< Offset into the record area */
+} sample_log_index_entry_t;
+
+/**
+ * @brief Segment header, at offset 0 of every segment
+ *
+ * committed and index_count are only accessed atomically: the writer
+ * publishes them with release stores after the data they cover. The magic
+ * is stamped the same way after the rest of the header, so a segment whose
+ * magic still reads 0 is being created.
+ */
+typedef struct {
+  uint32_t magic;             /**< SAMPLE_LOG_MAGIC */
+  uint16_t version;           /**< SAMPLE_LOG_VERSION */
+  uint16_t keyframe_interval; /**< Writer keyframe interval */
+  uint64_t segment;           /**< Segment number */
+  uint64_t first_ns;          /**< Time of the first record */
+  uint64_t last_ns;           /**< Time of the last record */
+  uint64_t committed;         /**< Record bytes fully written */
+  uint32_t index_count;       /**< Valid index entries */
+  uint32_t reserved;          /**< Padding */
+} sample_log_header_t;
+
+static inline uint32_t sample_log_zigzag32(int32_t value) {
+  return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static inline int32_t sample_log_unzigzag32(uint32_t value) {
+  return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+static inline uint64_t sample_log_zigzag64(int64_t value) {
+  return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static inline int64_t sample_log_unzigzag64(uint64_t value) {
+  return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+static inline uint8_t *sample_log_put_varint(uint8_t *out, uint64_t value) {
+  while (value >= 0x80) {
+    *out++ = (uint8_t)(value | 0x80);
+    value >>= 7;
+  }
+  *out++ = (uint8_t)value;
+  return out;
+}
+
+/** @return Bytes consumed, 0 if the varint runs past end or is too long */
+static inline size_t sample_log_get_varint(const uint8_t *in,
+                                           const uint8_t *end,
+                                           uint64_t *value) {
+  uint64_t result = 0;
+  for (size_t i = 0; i < 10 && in + i < end; i++) {
+    result |= (uint64_t)(in[i] & 0x7F) << (7 * i);
+    if ((in[i] & 0x80) == 0) {
+      *value = result;
+      return i + 1;
+    }
+  }
+  return 0;
+}
+
+/** @brief Channels stored per stream */
+static inline int sample_log_channels(sample_log_stream_t stream) {
+  return stream == SAMPLE_LOG_IMU ? 6 : 3;
+}
+
+/**
+ * @brief Build the path of a segment
+ * @return 0 on success, -1 if the path does not fit
+ */
+int sample_log_segment_path(char *path, size_t size, const char *directory,
+                             const char *prefix, uint64_t segment);
+
+/**
+ * @brief List the segment numbers of a log in ascending order
+ * @param segments Set to a malloc'ed array the caller frees
+ * @return Number of segments, negative value on error
+ */
+int sample_log_list_segments(const char *directory, const char *prefix,
+                             uint64_t **segments);
+
+#endif // SAMPLE_LOG_INTERNAL_H
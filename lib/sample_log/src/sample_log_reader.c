@@ -0,0 +1,367 @@
+/**
+ * @file sample_log_reader.c
+ * @brief Streaming sample log reader with sparse-index seeking
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "sample_log_internal.h"
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const sample_log_header_t *
+sample_log_reader_header(const sample_log_reader_t *reader) {
+  return (const sample_log_header_t *)reader->map;
+}
+
+static void sample_log_reader_unmap(sample_log_reader_t *reader) {
+  if (reader->map != NULL) {
+    munmap((void *)reader->map, reader->map_size);
+    close(reader->fd);
+    reader->map = NULL;
+    reader->fd = -1;
+  }
+}
+
+/**
+ * @brief Map a segment and make it the current one
+ *
+ * The reader is only moved once the segment is mapped; on failure or while
+ * the segment is not ready it keeps its previous position.
+ *
+ * @return 0 on success, SAMPLE_LOG_NOT_READY if the writer has created the
+ * segment but not stamped its header yet, -1 on error
+ */
+static int sample_log_reader_map(sample_log_reader_t *reader, size_t current) {
+  char path[SAMPLE_LOG_PATH_MAX];
+  if (sample_log_segment_path(path, sizeof(path), reader->directory,
+                              reader->prefix, reader->segments[current]) != 0) {
+    return -1;
+  }
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return -1;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    return -1;
+  }
+  if ((size_t)st.st_size < SAMPLE_LOG_HEADER_SIZE) {
+    // Created but not preallocated yet
+    close(fd);
+    return SAMPLE_LOG_NOT_READY;
+  }
+  const uint8_t *map =
+      mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  if (map == MAP_FAILED) {
+    close(fd);
+    return -1;
+  }
+  const sample_log_header_t *header = (const sample_log_header_t *)map;
+  uint32_t magic = __atomic_load_n(&header->magic, __ATOMIC_ACQUIRE);
+  if (magic != SAMPLE_LOG_MAGIC || header->version != SAMPLE_LOG_VERSION) {
+    munmap((void *)map, (size_t)st.st_size);
+    close(fd);
+    return magic == 0 ? SAMPLE_LOG_NOT_READY : -1;
+  }
+
+  sample_log_reader_unmap(reader);
+  reader->current = current;
+  reader->offset = 0;
+  memset(reader->known, 0, sizeof(reader->known));
+  reader->fd = fd;
+  reader->map = map;
+  reader->map_size = (size_t)st.st_size;
+  return 0;
+}
+
+int sample_log_reader_open(sample_log_reader_t *reader, const char *directory,
+                           const char *prefix) {
+  memset(reader, 0, sizeof(*reader));
+  reader->fd = -1;
+  if (strlen(directory) >= sizeof(reader->directory) ||
+      strlen(prefix) >= sizeof(reader->prefix)) {
+    return -1;
+  }
+  strcpy(reader->directory, directory);
+  strcpy(reader->prefix, prefix);
+
+  int count = sample_log_list_segments(directory, prefix, &reader->segments);
+  if (count < 0) {
+    return -1;
+  }
+  reader->segment_count = (size_t)count;
+  if (count == 0) {
+    return 0;
+  }
+  // A segment still being created is mapped by the first next()
+  return sample_log_reader_map(reader, 0) < 0 ? -1 : 0;
+}
+
+/**
+ * @brief Decode the record at the read position
+ * @return 1 on success, 0 if the segment has no further complete record
+ */
+static int sample_log_reader_decode(sample_log_reader_t *reader,
+                                    sample_log_record_t *record) {
+  const sample_log_header_t *header = sample_log_reader_header(reader);
+  size_t committed =
+      (size_t)__atomic_load_n(&header->committed, __ATOMIC_ACQUIRE);
+  if (committed > reader->map_size - SAMPLE_LOG_HEADER_SIZE) {
+    committed = reader->map_size - SAMPLE_LOG_HEADER_SIZE;
+  }
+
+  const uint8_t *data = reader->map + SAMPLE_LOG_HEADER_SIZE;
+  const uint8_t *in = data + reader->offset;
+  const uint8_t *end = data + committed;
+  if (in >= end || (*in & SAMPLE_LOG_TAG_MARKER) == 0) {
+    return 0;
+  }
+
+  uint8_t tag = *in++;
+  sample_log_stream_t stream =
+      (sample_log_stream_t)(tag & SAMPLE_LOG_TAG_STREAM);
+  if (stream >= SAMPLE_LOG_STREAMS) {
+    return 0;
+  }
+  int key = (tag & SAMPLE_LOG_TAG_KEYFRAME) != 0;
+  int channels = sample_log_channels(stream);
+
+  uint64_t field;
+  size_t used = sample_log_get_varint(in, end, &field);
+  if (used == 0) {
+    return 0;
+  }
+  in += used;
+  uint64_t timestamp_ns =
+      key ? field
+          : reader->last_ns[stream] + (uint64_t)sample_log_unzigzag64(field);
+
+  int32_t values[6];
+  for (int c = 0; c < channels; c++) {
+    used = sample_log_get_varint(in, end, &field);
+    if (used == 0) {
+      return 0;
+    }
+    in += used;
+    int32_t value = sample_log_unzigzag32((uint32_t)field);
+    values[c] = key ? value : reader->last[stream][c] + value;
+  }
+
+  reader->offset = (size_t)(in - data);
+  memcpy(reader->last[stream], values, (size_t)channels * sizeof(int32_t));
+  reader->last_ns[stream] = timestamp_ns;
+  if (key) {
+    reader->known[stream] = 1;
+  }
+  if (!reader->known[stream]) {
+    // Deltas from before the seek point, wait for this stream's keyframe
+    record->stream = SAMPLE_LOG_STREAMS;
+    return 1;
+  }
+
+  record->stream = stream;
+  record->timestamp_ns = timestamp_ns;
+  if (stream == SAMPLE_LOG_IMU) {
+    record->raw_acce.timestamp_ns = timestamp_ns;
+    record->raw_acce.raw_acce_x = (int16_t)values[0];
+    record->raw_acce.raw_acce_y = (int16_t)values[1];
+    record->raw_acce.raw_acce_z = (int16_t)values[2];
+    record->raw_gyro.timestamp_ns = timestamp_ns;
+    record->raw_gyro.raw_gyro_x = (int16_t)values[3];
+    record->raw_gyro.raw_gyro_y = (int16_t)values[4];
+    record->raw_gyro.raw_gyro_z = (int16_t)values[5];
+  } else {
+    record->env.timestamp_ns = timestamp_ns;
+    record->env.temperature = (float)values[0] / 100.0f;
+    record->env.pressure = (float)values[1] / 100.0f;
+    record->env.humidity = (float)values[2] / 1000.0f;
+  }
+  return 1;
+}
+
+/**
+ * @brief List the segments again to pick up those the writer rotated into
+ * @return 1 if a segment after the current one exists, 0 if not, -1 on
+ * error
+ */
+static int sample_log_reader_refresh(sample_log_reader_t *reader) {
+  uint64_t *segments;
+  int count =
+      sample_log_list_segments(reader->directory, reader->prefix, &segments);
+  if (count < 0) {
+    return -1;
+  }
+
+  // Keep pointing at the open segment, wherever it is in the new list
+  size_t current = 0;
+  if (reader->map != NULL) {
+    uint64_t open = reader->segments[reader->current];
+    while (current < (size_t)count && segments[current] <= open) {
+      current++;
+    }
+    current = current > 0 ? current - 1 : 0;
+  }
+  free(reader->segments);
+  reader->segments = segments;
+  reader->segment_count = (size_t)count;
+  reader->current = current;
+  if (reader->map == NULL) {
+    return count > 0;
+  }
+  return current + 1 < reader->segment_count;
+}
+
+int sample_log_reader_next(sample_log_reader_t *reader,
+                           sample_log_record_t *record) {
+  if (reader->map == NULL) {
+    // Opened before the writer created its first segment
+    int ret = sample_log_reader_refresh(reader);
+    if (ret <= 0) {
+      return ret;
+    }
+    ret = sample_log_reader_map(reader, 0);
+    if (ret != 0) {
+      return ret == SAMPLE_LOG_NOT_READY ? 0 : -1;
+    }
+  }
+
+  for (;;) {
+    int ret = sample_log_reader_decode(reader, record);
+    if (ret == 1) {
+      if (record->stream == SAMPLE_LOG_STREAMS) {
+        continue;
+      }
+      return 1;
+    }
+    // End of this segment: move on if a newer one exists, else wait here
+    if (reader->current + 1 >= reader->segment_count) {
+      ret = sample_log_reader_refresh(reader);
+      if (ret <= 0) {
+        return ret;
+      }
+      // The writer finishes a segment before creating the next one, so
+      // records committed since the decode above are final: drain them
+      if (sample_log_reader_decode(reader, record) == 1) {
+        if (record->stream == SAMPLE_LOG_STREAMS) {
+          continue;
+        }
+        return 1;
+      }
+    }
+    // A segment whose header is not stamped yet has no data either: stay
+    // at the end of this one and try again on the next call
+    ret = sample_log_reader_map(reader, reader->current + 1);
+    if (ret != 0) {
+      return ret == SAMPLE_LOG_NOT_READY ? 0 : -1;
+    }
+  }
+}
+
+int sample_log_reader_seek(sample_log_reader_t *reader, uint64_t timestamp_ns) {
+  if (sample_log_reader_refresh(reader) < 0) {
+    return -1;
+  }
+  if (reader->segment_count == 0) {
+    return 0;
+  }
+
+  // Last segment starting at or before the target
+  size_t target = 0;
+  for (size_t i = 0; i < reader->segment_count; i++) {
+    char path[SAMPLE_LOG_PATH_MAX];
+    sample_log_header_t header;
+    if (sample_log_segment_path(path, sizeof(path), reader->directory,
+                                reader->prefix, reader->segments[i]) != 0) {
+      continue;
+    }
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+      continue;
+    }
+    ssize_t got = pread(fd, &header, sizeof(header), 0);
+    close(fd);
+    if (got != (ssize_t)sizeof(header) || header.magic != SAMPLE_LOG_MAGIC) {
+      continue;
+    }
+    if (header.committed == 0 || header.first_ns > timestamp_ns) {
+      break;
+    }
+    target = i;
+  }
+  int mapped = sample_log_reader_map(reader, target);
+  if (mapped == SAMPLE_LOG_NOT_READY) {
+    // Nothing stamped to seek in yet, start from the first segment
+    sample_log_reader_unmap(reader);
+    return 0;
+  }
+  if (mapped != 0) {
+    return -1;
+  }
+
+  // Binary search the sparse index for the last entry at or before target
+  const sample_log_header_t *header = sample_log_reader_header(reader);
+  const sample_log_index_entry_t *index =
+      (const sample_log_index_entry_t *)(reader->map +
+                                         SAMPLE_LOG_INDEX_OFFSET);
+  size_t low = 0;
+  size_t high = __atomic_load_n(&header->index_count, __ATOMIC_ACQUIRE);
+  while (low < high) {
+    size_t mid = low + (high - low) / 2;
+    if (index[mid].timestamp_ns <= timestamp_ns) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  if (low > 0) {
+    reader->offset = (size_t)index[low - 1].offset;
+  }
+
+  // Walk forward to the first record at or after the target, keeping the
+  // decode position before each record. next() may list the segments again
+  // and replace the array, so the segment is remembered by number
+  for (;;) {
+    uint64_t segment = reader->segments[reader->current];
+    size_t offset = reader->offset;
+    int32_t last[SAMPLE_LOG_STREAMS][6];
+    uint64_t last_ns[SAMPLE_LOG_STREAMS];
+    int known[SAMPLE_LOG_STREAMS];
+    memcpy(last, reader->last, sizeof(last));
+    memcpy(last_ns, reader->last_ns, sizeof(last_ns));
+    memcpy(known, reader->known, sizeof(known));
+
+    sample_log_record_t record;
+    int ret = sample_log_reader_next(reader, &record);
+    if (ret <= 0) {
+      return ret;
+    }
+    if (record.timestamp_ns >= timestamp_ns) {
+      if (reader->segments[reader->current] == segment) {
+        reader->offset = offset;
+        memcpy(reader->last, last, sizeof(last));
+        memcpy(reader->last_ns, last_ns, sizeof(last_ns));
+        memcpy(reader->known, known, sizeof(known));
+      } else {
+        // The record opened a new segment, restart at its beginning
+        reader->offset = 0;
+        memset(reader->known, 0, sizeof(reader->known));
+      }
+      return 0;
+    }
+  }
+}
+
+void sample_log_reader_close(sample_log_reader_t *reader) {
+  sample_log_reader_unmap(reader);
+  free(reader->segments);
+  reader->segments = NULL;
+  reader->segment_count = 0;
+}
@@ -0,0 +1,133 @@
+/**
+ * @file sensor_shm.h
+ * @brief Latest-sample shared memory region and lock-free reader
+ *
+ * The acquisition process publishes the newest sample of every sensor
+ * channel into a POSIX shared memory object. Each channel is guarded by
+ * its own seqlock: the writer bumps the sequence to odd, stores the
+ * payload and bumps it back to even. Readers map the region read-only,
+ * copy the payload and retry if the sequence moved, so they never take a
+ * lock, never issue a syscall after opening and can never stall or slow
+ * down the writer.
+ *
+ * This header has no driver dependency so that consumer processes (radio,
+ * logger, health monitor) only need to link sensor_shm_reader.
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef SENSOR_SHM_H
+#define SENSOR_SHM_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef __cplusplus
+#include <stdatomic.h>
+/** @brief 32-bit word shared between the writer and the readers */
+typedef _Atomic uint32_t sensor_shm_word_t;
+#else
+/* C++ consumers only pass the region around, never touch the words */
+typedef uint32_t sensor_shm_word_t;
+#endif
+
+/** @brief Default shared memory object name */
+#define SENSOR_SHM_DEFAULT_NAME "/coreflight"
+/** @brief "SHMS" in little endian */
+#define SENSOR_SHM_MAGIC (0x534D4853)
+/** @brief Layout version, bumped on any change to sensor_shm_region_t */
+#define SENSOR_SHM_VERSION (1)
+/** @brief Cache line size used to keep channels apart */
+#define SENSOR_SHM_CACHE_LINE (64)
+/** @brief Payload words per channel (timestamp + three floats) */
+#define SENSOR_SHM_PAYLOAD_WORDS (5)
+
+/**
+ * @brief Published channels
+ */
+typedef enum {
+  SENSOR_SHM_ENV = 0,  /**< BME280: temperature (C), pressure (Pa), RH (%) */
+  SENSOR_SHM_ACCE = 1, /**< MPU6050 accelerometer: x, y, z in g */
+  SENSOR_SHM_GYRO = 2, /**< MPU6050 gyroscope: x, y, z in deg/s */
+  SENSOR_SHM_CHANNELS
+} sensor_shm_channel_t;
+
+/**
+ * @brief One sample as seen by readers
+ */
+typedef struct {
+  uint64_t timestamp_ns; /**< Acquisition time, CLOCK_MONOTONIC */
+  float value[3];        /**< Channel values, see sensor_shm_channel_t */
+  uint32_t sequence;     /**< Publications on this channel, wraps */
+} sensor_shm_sample_t;
+
+/**
+ * @brief Seqlock guarded slot, one per cache line
+ */
+typedef struct {
+  sensor_shm_word_t seq; /**< Odd while the writer is updating */
+  sensor_shm_word_t payload[SENSOR_SHM_PAYLOAD_WORDS]; /**< Sample words */
+  uint8_t reserved[SENSOR_SHM_CACHE_LINE -
+                   (SENSOR_SHM_PAYLOAD_WORDS + 1) * 4]; /**< Padding */
+} sensor_shm_slot_t;
+
+/**
+ * @brief Shared memory layout
+ */
+typedef struct {
+  sensor_shm_word_t magic;  /**< Written last by the publisher */
+  uint16_t version;         /**< SENSOR_SHM_VERSION */
+  uint16_t channels;        /**< SENSOR_SHM_CHANNELS */
+  uint32_t size;            /**< sizeof(sensor_shm_region_t) */
+  uint8_t reserved[SENSOR_SHM_CACHE_LINE - 12]; /**< Padding */
+  sensor_shm_slot_t slot[SENSOR_SHM_CHANNELS];  /**< Channel slots */
+} sensor_shm_region_t;
+
+/**
+ * @brief Reader handle
+ */
+typedef struct {
+  const sensor_shm_region_t *region; /**< Read-only mapping */
+  uint32_t last_seq[SENSOR_SHM_CHANNELS]; /**< Last sequence returned */
+} sensor_shm_reader_t;
+
+/**
+ * @brief Map an existing region read-only
+ * @param reader Reader handle
+ * @param name Shared memory object name, NULL for SENSOR_SHM_DEFAULT_NAME
+ * @return 0 on success, -1 if it does not exist, -2 on layout mismatch
+ */
+int sensor_shm_reader_open(sensor_shm_reader_t *reader, const char *name);
+
+/**
+ * @brief Take a consistent snapshot of the latest sample of a channel
+ *
+ * Never blocks the writer. If the writer is mid-update the copy is simply
+ * retried; after a bounded number of attempts the call gives up instead of
+ * spinning.
+ *
+ * @param reader Reader handle
+ * @param channel Channel to read
+ * @param sample Destination
+ * @return 1 for a sample not returned before, 0 if unchanged since the last
+ *         call, -1 if nothing was published yet, -2 if the writer kept the
+ *         slot busy
+ */
+int sensor_shm_read(sensor_shm_reader_t *reader, sensor_shm_channel_t channel,
+                    sensor_shm_sample_t *sample);
+
+/**
+ * @brief Unmap the region
+ * @param reader Reader handle
+ */
+void sensor_shm_reader_close(sensor_shm_reader_t *reader);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // SENSOR_SHM_H
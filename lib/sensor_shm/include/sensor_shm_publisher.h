@@ -0,0 +1,77 @@
+/**
+ * @file sensor_shm_publisher.h
+ * @brief Publish driver samples into the shared memory region
+ *
+ * There must be a single publisher per region. Publishing is a handful of
+ * relaxed stores and two release stores; the cost does not depend on how
+ * many readers have the region mapped.
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef SENSOR_SHM_PUBLISHER_H
+#define SENSOR_SHM_PUBLISHER_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "bme280.h"
+#include "mpu6050.h"
+#include "sensor_shm.h"
+
+/**
+ * @brief Publisher handle
+ */
+typedef struct {
+  sensor_shm_region_t *region; /**< Read-write mapping */
+  char name[64];               /**< Object name, unlinked on close */
+} sensor_shm_publisher_t;
+
+/**
+ * @brief Create (or take over) and initialise the region
+ * @param pub Publisher handle
+ * @param name Shared memory object name, NULL for SENSOR_SHM_DEFAULT_NAME
+ * @return 0 on success, -1 on error
+ */
+int sensor_shm_publisher_open(sensor_shm_publisher_t *pub, const char *name);
+
+/**
+ * @brief Publish a BME280 sample
+ * @param pub Publisher handle
+ * @param env Sample to publish
+ */
+void sensor_shm_publish_env(sensor_shm_publisher_t *pub,
+                            const bme280_sample_t *env);
+
+/**
+ * @brief Publish an accelerometer sample
+ * @param pub Publisher handle
+ * @param acce Sample to publish, in g
+ */
+void sensor_shm_publish_acce(sensor_shm_publisher_t *pub,
+                             const mpu6050_acce_value_t *acce);
+
+/**
+ * @brief Publish a gyroscope sample
+ * @param pub Publisher handle
+ * @param gyro Sample to publish, in deg/s
+ */
+void sensor_shm_publish_gyro(sensor_shm_publisher_t *pub,
+                             const mpu6050_gyro_value_t *gyro);
+
+/**
+ * @brief Unmap and unlink the region
+ *
+ * Readers that already mapped it keep their mapping and see the last
+ * published values; new readers fail to open until a publisher returns.
+ *
+ * @param pub Publisher handle
+ */
+void sensor_shm_publisher_close(sensor_shm_publisher_t *pub);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // SENSOR_SHM_PUBLISHER_H
@@ -0,0 +1,116 @@
+/**
+ * @file sensor_shm_publisher.c
+ * @brief Seqlock writer of the latest-sample region
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <sensor_shm_publisher.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <trace.h>
+#include <unistd.h>
+
+_Static_assert(sizeof(sensor_shm_slot_t) == SENSOR_SHM_CACHE_LINE,
+               "a slot must fill exactly one cache line");
+_Static_assert(sizeof(float) == sizeof(uint32_t), "float must be 32-bit");
+
+int sensor_shm_publisher_open(sensor_shm_publisher_t *pub, const char *name) {
+  memset(pub, 0, sizeof(*pub));
+  if (name == NULL) {
+    name = SENSOR_SHM_DEFAULT_NAME;
+  }
+  snprintf(pub->name, sizeof(pub->name), "%s", name);
+
+  int fd = shm_open(name, O_CREAT | O_RDWR, 0644);
+  if (fd < 0) {
+    fprintf(stderr, "Error creating shared memory %s\n", name);
+    return -1;
+  }
+  if (ftruncate(fd, sizeof(sensor_shm_region_t)) != 0) {
+    fprintf(stderr, "Error sizing shared memory %s\n", name);
+    close(fd);
+    return -1;
+  }
+  void *map = mmap(NULL, sizeof(sensor_shm_region_t), PROT_READ | PROT_WRITE,
+                   MAP_SHARED, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    fprintf(stderr, "Error mapping shared memory %s\n", name);
+    return -1;
+  }
+
+  sensor_shm_region_t *region = (sensor_shm_region_t *)map;
+  // Hide a stale region from new readers while it is being reset
+  atomic_store_explicit(&region->magic, 0, memory_order_relaxed);
+  for (int c = 0; c < SENSOR_SHM_CHANNELS; c++) {
+    atomic_store_explicit(&region->slot[c].seq, 0, memory_order_relaxed);
+  }
+  region->version = SENSOR_SHM_VERSION;
+  region->channels = SENSOR_SHM_CHANNELS;
+  region->size = sizeof(sensor_shm_region_t);
+  atomic_store_explicit(&region->magic, SENSOR_SHM_MAGIC,
+                        memory_order_release);
+  pub->region = region;
+  return 0;
+}
+
+/**
+ * @brief Seqlock write of one sample into a channel slot
+ */
+static void sensor_shm_publish(sensor_shm_publisher_t *pub,
+                               sensor_shm_channel_t channel,
+                               uint64_t timestamp_ns, float x, float y,
+                               float z) {
+  TRACE_BEGIN(publish);
+  sensor_shm_slot_t *slot = &pub->region->slot[channel];
+  float values[3] = {x, y, z};
+  uint32_t words[SENSOR_SHM_PAYLOAD_WORDS];
+  words[0] = (uint32_t)timestamp_ns;
+  words[1] = (uint32_t)(timestamp_ns >> 32);
+  memcpy(&words[2], values, sizeof(values));
+
+  // Single writer: the sequence is only ever modified here
+  uint32_t seq = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+  atomic_store_explicit(&slot->seq, seq + 1, memory_order_relaxed);
+  // Readers that see any new payload word must also see the odd sequence
+  atomic_thread_fence(memory_order_release);
+  for (int i = 0; i < SENSOR_SHM_PAYLOAD_WORDS; i++) {
+    atomic_store_explicit(&slot->payload[i], words[i], memory_order_relaxed);
+  }
+  // Skip 0 on wrap so readers can tell "never published" apart
+  uint32_t next = seq + 2 == 0 ? 2 : seq + 2;
+  atomic_store_explicit(&slot->seq, next, memory_order_release);
+  TRACE_END(publish, "shm_publish", channel);
+}
+
+void sensor_shm_publish_env(sensor_shm_publisher_t *pub,
+                            const bme280_sample_t *env) {
+  sensor_shm_publish(pub, SENSOR_SHM_ENV, env->timestamp_ns, env->temperature,
+                     env->pressure, env->humidity);
+}
+
+void sensor_shm_publish_acce(sensor_shm_publisher_t *pub,
+                             const mpu6050_acce_value_t *acce) {
+  sensor_shm_publish(pub, SENSOR_SHM_ACCE, acce->timestamp_ns, acce->acce_x,
+                     acce->acce_y, acce->acce_z);
+}
+
+void sensor_shm_publish_gyro(sensor_shm_publisher_t *pub,
+                             const mpu6050_gyro_value_t *gyro) {
+  sensor_shm_publish(pub, SENSOR_SHM_GYRO, gyro->timestamp_ns, gyro->gyro_x,
+                     gyro->gyro_y, gyro->gyro_z);
+}
+
+void sensor_shm_publisher_close(sensor_shm_publisher_t *pub) {
+  if (pub->region != NULL) {
+    munmap(pub->region, sizeof(sensor_shm_region_t));
+    shm_unlink(pub->name);
+    pub->region = NULL;
+  }
+}
@@ -0,0 +1,98 @@
+/**
+ * @file sensor_shm_reader.c
+ * @brief Lock-free reader of the latest-sample region
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <sensor_shm.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/** @brief Copy attempts before reporting the slot as busy */
+#define SENSOR_SHM_READ_RETRIES (64)
+
+int sensor_shm_reader_open(sensor_shm_reader_t *reader, const char *name) {
+  memset(reader, 0, sizeof(*reader));
+  if (name == NULL) {
+    name = SENSOR_SHM_DEFAULT_NAME;
+  }
+
+  int fd = shm_open(name, O_RDONLY, 0);
+  if (fd < 0) {
+    return -1;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(sensor_shm_region_t)) {
+    close(fd);
+    return -2;
+  }
+  void *map =
+      mmap(NULL, sizeof(sensor_shm_region_t), PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    fprintf(stderr, "Error mapping shared memory %s\n", name);
+    return -1;
+  }
+
+  const sensor_shm_region_t *region = (const sensor_shm_region_t *)map;
+  // Magic is stored last with release order, so the rest is valid after it
+  if (atomic_load_explicit(&region->magic, memory_order_acquire) !=
+          SENSOR_SHM_MAGIC ||
+      region->version != SENSOR_SHM_VERSION ||
+      region->channels != SENSOR_SHM_CHANNELS ||
+      region->size != sizeof(sensor_shm_region_t)) {
+    munmap(map, sizeof(sensor_shm_region_t));
+    return -2;
+  }
+  reader->region = region;
+  return 0;
+}
+
+int sensor_shm_read(sensor_shm_reader_t *reader, sensor_shm_channel_t channel,
+                    sensor_shm_sample_t *sample) {
+  const sensor_shm_slot_t *slot = &reader->region->slot[channel];
+  uint32_t words[SENSOR_SHM_PAYLOAD_WORDS];
+
+  for (int attempt = 0; attempt < SENSOR_SHM_READ_RETRIES; attempt++) {
+    uint32_t begin = atomic_load_explicit(&slot->seq, memory_order_acquire);
+    if (begin & 1) {
+      continue;
+    }
+    if (begin == 0) {
+      return -1;
+    }
+    for (int i = 0; i < SENSOR_SHM_PAYLOAD_WORDS; i++) {
+      words[i] =
+          atomic_load_explicit(&slot->payload[i], memory_order_relaxed);
+    }
+    // Order the payload loads before the re-check of the sequence
+    atomic_thread_fence(memory_order_acquire);
+    if (atomic_load_explicit(&slot->seq, memory_order_relaxed) != begin) {
+      continue;
+    }
+
+    sample->timestamp_ns = (uint64_t)words[0] | ((uint64_t)words[1] << 32);
+    memcpy(sample->value, &words[2], sizeof(sample->value));
+    sample->sequence = begin >> 1;
+    if (reader->last_seq[channel] == begin) {
+      return 0;
+    }
+    reader->last_seq[channel] = begin;
+    return 1;
+  }
+  return -2;
+}
+
+void sensor_shm_reader_close(sensor_shm_reader_t *reader) {
+  if (reader->region != NULL) {
+    munmap((void *)reader->region, sizeof(sensor_shm_region_t));
+    reader->region = NULL;
+  }
+}
@@ -0,0 +1,124 @@
+/**
+ * @file sensor_stream.h
+ * @brief Wire protocol and client side of the sensord sample streams
+ *
+ * sensord owns the buses and serves any number of local clients over a
+ * SOCK_SEQPACKET Unix domain socket, so every message below is delivered
+ * whole. A client sends a sensor_stream_subscribe_t (again at any time to
+ * change it) and then receives frames: one sensor_stream_header_t followed
+ * by header.count samples. Integers use host byte order, the socket never
+ * leaves the machine.
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef SENSOR_STREAM_H
+#define SENSOR_STREAM_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** @brief Default socket path of the daemon */
+#define SENSOR_STREAM_DEFAULT_PATH "/tmp/coreflight-sensord.sock"
+/** @brief "SSTR" in little endian, first word of every message */
+#define SENSOR_STREAM_MAGIC (0x52545353)
+/** @brief Largest batch a client may ask for */
+#define SENSOR_STREAM_MAX_BATCH (64)
+
+/**
+ * @brief Stream channels, used as bit positions in the channel mask
+ */
+typedef enum {
+  SENSOR_STREAM_ENV = 0,  /**< BME280: temperature (C), pressure (Pa), RH */
+  SENSOR_STREAM_ACCE = 1, /**< MPU6050 accelerometer: x, y, z in g */
+  SENSOR_STREAM_GYRO = 2, /**< MPU6050 gyroscope: x, y, z in deg/s */
+  SENSOR_STREAM_CHANNELS
+} sensor_stream_channel_t;
+
+/** @brief Mask bit of a channel */
+#define SENSOR_STREAM_BIT(channel) (1u << (channel))
+/** @brief Every channel */
+#define SENSOR_STREAM_ALL ((1u << SENSOR_STREAM_CHANNELS) - 1)
+
+/**
+ * @brief Client to daemon: replace the subscription
+ */
+typedef struct {
+  uint32_t magic;        /**< SENSOR_STREAM_MAGIC */
+  uint32_t channel_mask; /**< SENSOR_STREAM_BIT() set, 0 pauses the stream */
+  uint16_t decimation;   /**< Keep one of every N samples per channel */
+  uint16_t batch;        /**< Samples per frame, 1..SENSOR_STREAM_MAX_BATCH */
+} sensor_stream_subscribe_t;
+
+/**
+ * @brief Daemon to client: frame header
+ */
+typedef struct {
+  uint32_t magic;    /**< SENSOR_STREAM_MAGIC */
+  uint16_t count;    /**< Samples following the header */
+  uint16_t reserved; /**< Zero */
+  uint32_t sequence; /**< Frames produced for this client, gaps = drops */
+  uint32_t dropped;  /**< Samples dropped for this client so far */
+} sensor_stream_header_t;
+
+/**
+ * @brief One sample on the wire
+ */
+typedef struct {
+  uint64_t timestamp_ns; /**< Acquisition time, CLOCK_MONOTONIC */
+  uint8_t channel;       /**< sensor_stream_channel_t */
+  uint8_t reserved[3];   /**< Zero */
+  float value[3];        /**< Channel values */
+} sensor_stream_sample_t;
+
+/**
+ * @brief Largest message the daemon sends
+ */
+typedef struct {
+  sensor_stream_header_t header;                          /**< Header */
+  sensor_stream_sample_t sample[SENSOR_STREAM_MAX_BATCH]; /**< Samples */
+} sensor_stream_frame_t;
+
+/**
+ * @brief Connect to the daemon
+ * @param path Socket path, NULL for SENSOR_STREAM_DEFAULT_PATH
+ * @return Socket descriptor, -1 on error
+ */
+int sensor_stream_connect(const char *path);
+
+/**
+ * @brief Send (or replace) the subscription
+ * @param fd Socket from sensor_stream_connect()
+ * @param channel_mask Channels to receive
+ * @param decimation Keep one of every N samples, 0 is treated as 1
+ * @param batch Samples per frame, clamped to SENSOR_STREAM_MAX_BATCH
+ * @return 0 on success, -1 on error
+ */
+int sensor_stream_subscribe(int fd, uint32_t channel_mask, uint16_t decimation,
+                            uint16_t batch);
+
+/**
+ * @brief Block until the next frame arrives
+ * @param fd Socket from sensor_stream_connect()
+ * @param frame Destination
+ * @return Number of samples in the frame, 0 when the daemon closed the
+ *         connection, -1 on error or malformed frame
+ */
+int sensor_stream_receive(int fd, sensor_stream_frame_t *frame);
+
+/**
+ * @brief Bytes of a frame carrying a given number of samples
+ * @param count Samples in the frame
+ * @return Message size
+ */
+size_t sensor_stream_frame_size(uint16_t count);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // SENSOR_STREAM_H
@@ -0,0 +1,72 @@
+/**
+ * @file sensor_stream.c
+ * @brief Client side of the sensord sample streams
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <sensor_stream.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+size_t sensor_stream_frame_size(uint16_t count) {
+  return sizeof(sensor_stream_header_t) +
+         (size_t)count * sizeof(sensor_stream_sample_t);
+}
+
+int sensor_stream_connect(const char *path) {
+  if (path == NULL) {
+    path = SENSOR_STREAM_DEFAULT_PATH;
+  }
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (strlen(path) >= sizeof(addr.sun_path)) {
+    return -1;
+  }
+  strcpy(addr.sun_path, path);
+
+  int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    return -1;
+  }
+  if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+    fprintf(stderr, "Error connecting to %s\n", path);
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+int sensor_stream_subscribe(int fd, uint32_t channel_mask, uint16_t decimation,
+                            uint16_t batch) {
+  sensor_stream_subscribe_t request = {
+      .magic = SENSOR_STREAM_MAGIC,
+      .channel_mask = channel_mask & SENSOR_STREAM_ALL,
+      .decimation = decimation == 0 ? 1 : decimation,
+      .batch = batch == 0                         ? 1
+               : batch > SENSOR_STREAM_MAX_BATCH ? SENSOR_STREAM_MAX_BATCH
+                                                 : batch,
+  };
+  ssize_t sent = send(fd, &request, sizeof(request), MSG_NOSIGNAL);
+  return sent == (ssize_t)sizeof(request) ? 0 : -1;
+}
+
+int sensor_stream_receive(int fd, sensor_stream_frame_t *frame) {
+  ssize_t length = recv(fd, frame, sizeof(*frame), 0);
+  if (length <= 0) {
+    return length == 0 ? 0 : -1;
+  }
+  if ((size_t)length < sizeof(frame->header) ||
+      frame->header.magic != SENSOR_STREAM_MAGIC ||
+      frame->header.count > SENSOR_STREAM_MAX_BATCH ||
+      (size_t)length != sensor_stream_frame_size(frame->header.count)) {
+    return -1;
+  }
+  return frame->header.count;
+}
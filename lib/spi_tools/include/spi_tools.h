@@ -0,0 +1,77 @@
+/**
+ * @file spi_tools.h
+ * @brief SPI transports exposed through the i2c_tools backend interface
+ *
+ * Register-oriented sensors such as the BME280 use the same register map
+ * over SPI, with the first byte of every transfer carrying the register
+ * address and bit 7 as the direction flag (1 = read, 0 = write). These
+ * backends apply that convention, so drivers keep calling
+ * i2c_tools_read_reg()/i2c_tool_write_reg() unchanged once their bus is
+ * switched (e.g. bme280_set_bus()). Only 4-wire SPI is supported; leave
+ * spi3w_en cleared in the BME280 config register.
+ *
+ * Two flavours are provided: the bcm2835 SPI0 controller driven directly
+ * and the Linux spidev interface (/dev/spidevB.C). The slave address given
+ * to i2c_tools_select() is ignored, the chip select fixes the device.
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef SPI_TOOLS_H
+#define SPI_TOOLS_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "i2c_tools.h"
+#include <stdint.h>
+
+/** @brief Default clock, the BME280 accepts up to 10 MHz */
+#define SPI_TOOLS_DEFAULT_SPEED_HZ (10000000)
+
+/** @brief Direction flag in the register byte */
+#define SPI_TOOLS_READ_FLAG (0x80)
+
+/**
+ * @brief SPI transport state, owns the backend handed to the drivers
+ */
+typedef struct {
+  i2c_tools_backend_t backend; /**< Pass &backend to the driver */
+  uint32_t speed_hz;           /**< SCLK frequency */
+  uint8_t chip_select;         /**< bcm2835: CS line (0 or 1) */
+  char device[32];             /**< spidev: device node */
+  int fd;                      /**< spidev: open descriptor, -1 if closed */
+  int started;                 /**< bcm2835: holds a reference on SPI0 */
+} spi_tools_t;
+
+/**
+ * @brief Prepare a transport on the bcm2835 SPI0 controller
+ *
+ * Nothing touches the hardware until the driver initialises the bus.
+ *
+ * @param spi Transport state, must outlive its use by the drivers
+ * @param chip_select CS line the sensor is wired to (0 or 1)
+ * @param speed_hz SCLK frequency, 0 for SPI_TOOLS_DEFAULT_SPEED_HZ
+ * @return Backend to pass to the driver
+ */
+const i2c_tools_backend_t *spi_tools_bcm2835(spi_tools_t *spi,
+                                             uint8_t chip_select,
+                                             uint32_t speed_hz);
+
+/**
+ * @brief Prepare a transport on a Linux spidev node
+ * @param spi Transport state, must outlive its use by the drivers
+ * @param device Device node, e.g. "/dev/spidev0.0"
+ * @param speed_hz SCLK frequency, 0 for SPI_TOOLS_DEFAULT_SPEED_HZ
+ * @return Backend to pass to the driver
+ */
+const i2c_tools_backend_t *spi_tools_spidev(spi_tools_t *spi,
+                                            const char *device,
+                                            uint32_t speed_hz);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // SPI_TOOLS_H
@@ -0,0 +1,231 @@
+/**
+ * @file spi_tools.c
+ * @brief bcm2835 and spidev SPI transports
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <spi_tools.h>
+#include <fcntl.h>
+#include <linux/spi/spidev.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include <unistd.h>
+
+/** @brief Register byte plus the longest i2c_tools transfer */
+#define SPI_TOOLS_MAX_TRANSFER (1 + 255)
+
+static uint64_t spi_tools_monotonic_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int spi_tools_select(void *ctx, uint8_t slave_addr) {
+  // The chip select identifies the device, there is no address phase
+  (void)ctx;
+  (void)slave_addr;
+  return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+/* bcm2835 SPI0                                                             */
+/* ------------------------------------------------------------------------ */
+
+/* SPI0 is one controller shared by every transport on it (one per chip
+ * select): it is started by the first transport and stopped by the last */
+static pthread_mutex_t spi_bcm2835_lock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned int spi_bcm2835_users = 0;
+
+static int spi_bcm2835_init(void *ctx) {
+  spi_tools_t *spi = (spi_tools_t *)ctx;
+  if (!spi->started) {
+    if (i2c_tools_bcm2835_acquire() != 0) {
+      return -1;
+    }
+    pthread_mutex_lock(&spi_bcm2835_lock);
+    int begun = spi_bcm2835_users > 0 || bcm2835_spi_begin();
+    if (begun) {
+      spi_bcm2835_users++;
+    }
+    pthread_mutex_unlock(&spi_bcm2835_lock);
+    if (!begun) {
+      fprintf(stderr, "Error starting SPI (are you running as root?)\n");
+      i2c_tools_bcm2835_release();
+      return -1;
+    }
+    spi->started = 1;
+  }
+  bcm2835_spi_setBitOrder(BCM2835_SPI_BIT_ORDER_MSBFIRST);
+  bcm2835_spi_setDataMode(BCM2835_SPI_MODE0);
+  bcm2835_spi_set_speed_hz(spi->speed_hz);
+  bcm2835_spi_chipSelect(spi->chip_select);
+  bcm2835_spi_setChipSelectPolarity(spi->chip_select, LOW);
+  return 0;
+}
+
+static void spi_bcm2835_set_speed(void *ctx, uint32_t speed_hz) {
+  spi_tools_t *spi = (spi_tools_t *)ctx;
+  spi->speed_hz = speed_hz;
+  bcm2835_spi_set_speed_hz(speed_hz);
+}
+
+static int spi_bcm2835_read_reg(void *ctx, uint8_t reg_address, char *buffer,
+                                uint8_t length, uint64_t *timestamp_ns) {
+  spi_tools_t *spi = (spi_tools_t *)ctx;
+  char tx[SPI_TOOLS_MAX_TRANSFER] = {0};
+  char rx[SPI_TOOLS_MAX_TRANSFER];
+  tx[0] = (char)(reg_address | SPI_TOOLS_READ_FLAG);
+  bcm2835_spi_chipSelect(spi->chip_select);
+  // The address byte takes < 1 us at these clocks, the data latch follows it
+  *timestamp_ns = spi_tools_monotonic_ns();
+  bcm2835_spi_transfernb(tx, rx, (uint32_t)length + 1);
+  memcpy(buffer, &rx[1], length);
+  return 0;
+}
+
+static int spi_bcm2835_write_reg(void *ctx, uint8_t reg_address,
+                                 uint8_t data) {
+  spi_tools_t *spi = (spi_tools_t *)ctx;
+  char tx[2] = {(char)(reg_address & ~SPI_TOOLS_READ_FLAG), (char)data};
+  bcm2835_spi_chipSelect(spi->chip_select);
+  bcm2835_spi_transfern(tx, 2);
+  return 0;
+}
+
+static void spi_bcm2835_cleanup(void *ctx) {
+  spi_tools_t *spi = (spi_tools_t *)ctx;
+  if (!spi->started) {
+    return;
+  }
+  spi->started = 0;
+  pthread_mutex_lock(&spi_bcm2835_lock);
+  if (--spi_bcm2835_users == 0) {
+    bcm2835_spi_end();
+  }
+  pthread_mutex_unlock(&spi_bcm2835_lock);
+  i2c_tools_bcm2835_release();
+}
+
+const i2c_tools_backend_t *spi_tools_bcm2835(spi_tools_t *spi,
+                                             uint8_t chip_select,
+                                             uint32_t speed_hz) {
+  memset(spi, 0, sizeof(*spi));
+  spi->fd = -1;
+  spi->chip_select = chip_select;
+  spi->speed_hz = speed_hz != 0 ? speed_hz : SPI_TOOLS_DEFAULT_SPEED_HZ;
+  spi->backend.init = spi_bcm2835_init;
+  spi->backend.set_slave_address = spi_tools_select;
+  spi->backend.set_baudrate = spi_bcm2835_set_speed;
+  spi->backend.read_reg = spi_bcm2835_read_reg;
+  spi->backend.write_reg = spi_bcm2835_write_reg;
+  spi->backend.cleanup = spi_bcm2835_cleanup;
+  spi->backend.ctx = spi;
+  return &spi->backend;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Linux spidev                                                             */
+/* ------------------------------------------------------------------------ */
+
+static int spi_spidev_transfer(spi_tools_t *spi, const uint8_t *tx,
+                               uint8_t *rx, uint32_t length) {
+  struct spi_ioc_transfer transfer;
+  memset(&transfer, 0, sizeof(transfer));
+  transfer.tx_buf = (uintptr_t)tx;
+  transfer.rx_buf = (uintptr_t)rx;
+  transfer.len = length;
+  transfer.speed_hz = spi->speed_hz;
+  transfer.bits_per_word = 8;
+  return ioctl(spi->fd, SPI_IOC_MESSAGE(1), &transfer) < 0 ? -3 : 0;
+}
+
+static int spi_spidev_init(void *ctx) {
+  spi_tools_t *spi = (spi_tools_t *)ctx;
+  if (spi->fd >= 0) {
+    return 0;
+  }
+  spi->fd = open(spi->device, O_RDWR | O_CLOEXEC);
+  if (spi->fd < 0) {
+    fprintf(stderr, "Error opening %s\n", spi->device);
+    return -1;
+  }
+  uint8_t mode = SPI_MODE_0;
+  uint8_t bits = 8;
+  if (ioctl(spi->fd, SPI_IOC_WR_MODE, &mode) < 0 ||
+      ioctl(spi->fd, SPI_IOC_WR_BITS_PER_WORD, &bits) < 0 ||
+      ioctl(spi->fd, SPI_IOC_WR_MAX_SPEED_HZ, &spi->speed_hz) < 0) {
+    fprintf(stderr, "Error configuring %s\n", spi->device);
+    close(spi->fd);
+    spi->fd = -1;
+    return -1;
+  }
+  return 0;
+}
+
+static void spi_spidev_set_speed(void *ctx, uint32_t speed_hz) {
+  spi_tools_t *spi = (spi_tools_t *)ctx;
+  spi->speed_hz = speed_hz;
+}
+
+static int spi_spidev_read_reg(void *ctx, uint8_t reg_address, char *buffer,
+                               uint8_t length, uint64_t *timestamp_ns) {
+  spi_tools_t *spi = (spi_tools_t *)ctx;
+  uint8_t tx[SPI_TOOLS_MAX_TRANSFER] = {0};
+  uint8_t rx[SPI_TOOLS_MAX_TRANSFER];
+  tx[0] = reg_address | SPI_TOOLS_READ_FLAG;
+  *timestamp_ns = spi_tools_monotonic_ns();
+  int ret = spi_spidev_transfer(spi, tx, rx, (uint32_t)length + 1);
+  if (ret != 0) {
+    return ret;
+  }
+  memcpy(buffer, &rx[1], length);
+  return 0;
+}
+
+static int spi_spidev_write_reg(void *ctx, uint8_t reg_address,
+                                uint8_t data) {
+  spi_tools_t *spi = (spi_tools_t *)ctx;
+  uint8_t tx[2] = {(uint8_t)(reg_address & ~SPI_TOOLS_READ_FLAG), data};
+  uint8_t rx[2];
+  return spi_spidev_transfer(spi, tx, rx, 2);
+}
+
+static void spi_spidev_cleanup(void *ctx) {
+  spi_tools_t *spi = (spi_tools_t *)ctx;
+  if (spi->fd >= 0) {
+    close(spi->fd);
+    spi->fd = -1;
+  }
+}
+
+static void spi_spidev_delay_us(void *ctx, uint32_t micros) {
+  (void)ctx;
+  struct timespec ts = {(time_t)(micros / 1000000),
+                        (long)(micros % 1000000) * 1000};
+  nanosleep(&ts, NULL);
+}
+
+const i2c_tools_backend_t *spi_tools_spidev(spi_tools_t *spi,
+                                            const char *device,
+                                            uint32_t speed_hz) {
+  memset(spi, 0, sizeof(*spi));
+  spi->fd = -1;
+  snprintf(spi->device, sizeof(spi->device), "%s", device);
+  spi->speed_hz = speed_hz != 0 ? speed_hz : SPI_TOOLS_DEFAULT_SPEED_HZ;
+  spi->backend.init = spi_spidev_init;
+  spi->backend.set_slave_address = spi_tools_select;
+  spi->backend.set_baudrate = spi_spidev_set_speed;
+  spi->backend.read_reg = spi_spidev_read_reg;
+  spi->backend.write_reg = spi_spidev_write_reg;
+  spi->backend.cleanup = spi_spidev_cleanup;
+  // No bcm2835 mapping behind spidev, sleep with the kernel instead
+  spi->backend.delay_us = spi_spidev_delay_us;
+  spi->backend.ctx = spi;
+  return &spi->backend;
+}
@@ -0,0 +1,194 @@
+/**
+ * @file telemetry.h
+ * @brief Compact binary telemetry frames for the LoRa downlink
+ *
+ * Samples are quantized to fixed-point steps, delta-encoded against the
+ * previous record and bit-packed with per-frame channel widths into frames
+ * that never exceed the configured LoRa payload size.
+ *
+ * Frame layout (little endian):
+ *   - byte 0: version (high nibble) and flags (low nibble)
+ *   - bytes 1-2: sequence number
+ *   - byte 3: record count
+ *   - bytes 4-7: timestamp of the first record in milliseconds
+ *   - bit-packed widths, 5 bits for the timestamp delta and each channel
+ *   - bit-packed records, zigzag deltas using those widths
+ *   - CRC-16/CCITT-FALSE over everything before it
+ *
+ * The first record of a keyframe is coded against zero, so a decoder can
+ * start or resynchronize there; other frames chain from the last record of
+ * the previous frame.
+ *
+ * This header does not depend on the sensor drivers, so the decoder can be
+ * built on the ground station.
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** @brief Frame format version */
+#define TELEMETRY_VERSION (1)
+
+/** @brief Frame flag: first record is coded against zero */
+#define TELEMETRY_FLAG_KEYFRAME (0x01)
+
+/** @brief Fixed bytes per frame: header plus CRC */
+#define TELEMETRY_OVERHEAD_BYTES (10)
+
+/** @brief Largest number of records in a single frame */
+#define TELEMETRY_MAX_RECORDS (64)
+
+/** @brief Default payload limit, fits every LoRaWAN data rate above DR2 */
+#define TELEMETRY_DEFAULT_PAYLOAD (222)
+
+/**
+ * @brief Error codes
+ */
+enum {
+  TELEMETRY_ERR_LENGTH = -1,       /**< Frame too short or truncated */
+  TELEMETRY_ERR_CRC = -2,          /**< CRC mismatch */
+  TELEMETRY_ERR_VERSION = -3,      /**< Unknown frame version */
+  TELEMETRY_ERR_NO_REFERENCE = -4, /**< Frame lost before, await keyframe */
+  TELEMETRY_ERR_CONFIG = -5,       /**< Invalid configuration */
+  TELEMETRY_ERR_DUPLICATE = -6     /**< Repeated or late frame, dropped */
+};
+
+/**
+ * @brief Telemetry channels, in frame order
+ */
+typedef enum {
+  TELEMETRY_TEMPERATURE = 0, /**< °C */
+  TELEMETRY_PRESSURE,        /**< Pa */
+  TELEMETRY_HUMIDITY,        /**< % */
+  TELEMETRY_ACCE_X,          /**< g */
+  TELEMETRY_ACCE_Y,          /**< g */
+  TELEMETRY_ACCE_Z,          /**< g */
+  TELEMETRY_GYRO_X,          /**< deg/s */
+  TELEMETRY_GYRO_Y,          /**< deg/s */
+  TELEMETRY_GYRO_Z,          /**< deg/s */
+  TELEMETRY_CHANNELS
+} telemetry_channel_t;
+
+/**
+ * @brief One combined sample
+ */
+typedef struct {
+  uint64_t timestamp_ns;              /**< Monotonic sample time */
+  float values[TELEMETRY_CHANNELS];   /**< Physical values per channel */
+} telemetry_record_t;
+
+/**
+ * @brief Packetizer configuration, must match on both ends
+ */
+typedef struct {
+  float resolution[TELEMETRY_CHANNELS]; /**< Quantization step per channel */
+  size_t max_payload;                   /**< Frame size limit in bytes */
+  uint16_t keyframe_interval;           /**< Frames between keyframes */
+} telemetry_config_t;
+
+/**
+ * @brief Encoder state
+ */
+typedef struct {
+  telemetry_config_t config;                 /**< Active configuration */
+  int32_t records[TELEMETRY_MAX_RECORDS][TELEMETRY_CHANNELS]; /**< Pending */
+  uint32_t timestamps[TELEMETRY_MAX_RECORDS]; /**< Pending times (ms) */
+  int32_t reference[TELEMETRY_CHANNELS];     /**< Last record sent */
+  uint8_t widths[TELEMETRY_CHANNELS + 1];    /**< Widths of the open frame */
+  size_t count;                              /**< Records in the open frame */
+  int keyframe;                              /**< Open frame is a keyframe */
+  uint16_t sequence;                         /**< Next sequence number */
+  uint16_t frames_since_key;                 /**< Frames since a keyframe */
+} telemetry_encoder_t;
+
+/**
+ * @brief Decoder state
+ */
+typedef struct {
+  telemetry_config_t config;             /**< Active configuration */
+  int32_t reference[TELEMETRY_CHANNELS]; /**< Last record received */
+  uint16_t sequence;                     /**< Expected sequence number */
+  int synced;                            /**< Non-zero once a key was seen */
+  uint32_t lost_frames;                  /**< Sequence gaps observed */
+} telemetry_decoder_t;
+
+/**
+ * @brief Fill a configuration with the default resolutions
+ * @param config Configuration to fill
+ */
+void telemetry_default_config(telemetry_config_t *config);
+
+/**
+ * @brief Initialize an encoder
+ * @param enc Encoder state
+ * @param config Configuration, or NULL for the defaults
+ * @return 0 on success, TELEMETRY_ERR_CONFIG if the payload limit is too
+ * small for a single record
+ */
+int telemetry_encoder_init(telemetry_encoder_t *enc,
+                           const telemetry_config_t *config);
+
+/**
+ * @brief Add a record, emitting a frame when the open one is full
+ *
+ * A timestamp earlier than the previous record, or 2^31 ms or more after
+ * it, also closes the open frame and starts a new one.
+ *
+ * @param enc Encoder state
+ * @param record Record to add
+ * @param frame Output buffer of at least config.max_payload bytes
+ * @param length Set to the frame length when one is emitted
+ * @return 1 if a frame was emitted, 0 otherwise
+ */
+int telemetry_encoder_push(telemetry_encoder_t *enc,
+                           const telemetry_record_t *record, uint8_t *frame,
+                           size_t *length);
+
+/**
+ * @brief Emit the open frame even if it is not full
+ * @param enc Encoder state
+ * @param frame Output buffer of at least config.max_payload bytes
+ * @param length Set to the frame length when one is emitted
+ * @return 1 if a frame was emitted, 0 if there was nothing pending
+ */
+int telemetry_encoder_flush(telemetry_encoder_t *enc, uint8_t *frame,
+                            size_t *length);
+
+/**
+ * @brief Initialize a decoder
+ * @param dec Decoder state
+ * @param config Configuration, or NULL for the defaults
+ */
+void telemetry_decoder_init(telemetry_decoder_t *dec,
+                            const telemetry_config_t *config);
+
+/**
+ * @brief Decode one frame
+ *
+ * A frame numbered a little behind the expected one, as a duplicated or
+ * reordered radio frame is, is dropped with TELEMETRY_ERR_DUPLICATE. It is
+ * not counted as lost and leaves the decoder in sync.
+ *
+ * @param dec Decoder state
+ * @param frame Received frame
+ * @param length Frame length in bytes
+ * @param records Output records, at least TELEMETRY_MAX_RECORDS
+ * @return Number of records decoded, or a negative TELEMETRY_ERR_* code
+ */
+int telemetry_decode(telemetry_decoder_t *dec, const uint8_t *frame,
+                     size_t length, telemetry_record_t *records);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // TELEMETRY_H
@@ -0,0 +1,38 @@
+/**
+ * @file telemetry_sensors.h
+ * @brief Build telemetry records from the driver sample structs
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef TELEMETRY_SENSORS_H
+#define TELEMETRY_SENSORS_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "bme280.h"
+#include "mpu6050.h"
+#include "telemetry.h"
+
+/**
+ * @brief Combine one sample of each sensor into a record
+ *
+ * The record takes the newest timestamp of the three samples.
+ *
+ * @param record Destination record
+ * @param env BME280 sample
+ * @param acce Accelerometer sample in g
+ * @param gyro Gyroscope sample in deg/s
+ */
+void telemetry_record_from_samples(telemetry_record_t *record,
+                                   const bme280_sample_t *env,
+                                   const mpu6050_acce_value_t *acce,
+                                   const mpu6050_gyro_value_t *gyro);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // TELEMETRY_SENSORS_H
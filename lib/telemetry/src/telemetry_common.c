@@ -0,0 +1,36 @@
+/**
+ * @file telemetry_common.c
+ * @brief Configuration and CRC shared by the telemetry encoder and decoder
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "telemetry_internal.h"
+
+void telemetry_default_config(telemetry_config_t *config) {
+  config->resolution[TELEMETRY_TEMPERATURE] = 0.01f;
+  config->resolution[TELEMETRY_PRESSURE] = 1.0f;
+  config->resolution[TELEMETRY_HUMIDITY] = 0.01f;
+  config->resolution[TELEMETRY_ACCE_X] = 0.001f;
+  config->resolution[TELEMETRY_ACCE_Y] = 0.001f;
+  config->resolution[TELEMETRY_ACCE_Z] = 0.001f;
+  config->resolution[TELEMETRY_GYRO_X] = 0.01f;
+  config->resolution[TELEMETRY_GYRO_Y] = 0.01f;
+  config->resolution[TELEMETRY_GYRO_Z] = 0.01f;
+  config->max_payload = TELEMETRY_DEFAULT_PAYLOAD;
+  config->keyframe_interval = 8;
+}
+
+uint16_t telemetry_crc16(const uint8_t *data, size_t length) {
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < length; i++) {
+    crc ^= (uint16_t)data[i] << 8;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021)
+                           : (uint16_t)(crc << 1);
+    }
+  }
+  return crc;
+}
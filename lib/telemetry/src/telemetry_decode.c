@@ -0,0 +1,101 @@
+/**
+ * @file telemetry_decode.c
+ * @brief Telemetry frame decoder for the ground station
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "telemetry_internal.h"
+#include <string.h>
+
+void telemetry_decoder_init(telemetry_decoder_t *dec,
+                            const telemetry_config_t *config) {
+  memset(dec, 0, sizeof(*dec));
+  if (config != NULL) {
+    dec->config = *config;
+  } else {
+    telemetry_default_config(&dec->config);
+  }
+}
+
+int telemetry_decode(telemetry_decoder_t *dec, const uint8_t *frame,
+                     size_t length, telemetry_record_t *records) {
+  size_t min_length =
+      TELEMETRY_OVERHEAD_BYTES + (TELEMETRY_WIDTH_TABLE_BITS + 7) / 8;
+  if (length < min_length) {
+    return TELEMETRY_ERR_LENGTH;
+  }
+  uint16_t crc = (uint16_t)(frame[length - 2] | (frame[length - 1] << 8));
+  if (crc != telemetry_crc16(frame, length - 2)) {
+    return TELEMETRY_ERR_CRC;
+  }
+  if ((frame[0] >> 4) != TELEMETRY_VERSION) {
+    return TELEMETRY_ERR_VERSION;
+  }
+
+  int keyframe = (frame[0] & TELEMETRY_FLAG_KEYFRAME) != 0;
+  uint16_t sequence = (uint16_t)(frame[1] | (frame[2] << 8));
+  size_t count = frame[3];
+  uint32_t ms = (uint32_t)frame[4] | ((uint32_t)frame[5] << 8) |
+                ((uint32_t)frame[6] << 16) | ((uint32_t)frame[7] << 24);
+  if (count == 0 || count > TELEMETRY_MAX_RECORDS) {
+    return TELEMETRY_ERR_LENGTH;
+  }
+
+  // Already decoded, or overtaken by a newer frame: not a loss
+  uint16_t behind = (uint16_t)(dec->sequence - sequence);
+  if (dec->synced && behind != 0 && behind <= TELEMETRY_REORDER_WINDOW) {
+    return TELEMETRY_ERR_DUPLICATE;
+  }
+  if (dec->synced && sequence != dec->sequence) {
+    dec->lost_frames += (uint16_t)(sequence - dec->sequence);
+    dec->synced = 0;
+  }
+  if (!keyframe && !dec->synced) {
+    // The delta chain is broken until the next keyframe
+    dec->sequence = (uint16_t)(sequence + 1);
+    return TELEMETRY_ERR_NO_REFERENCE;
+  }
+
+  telemetry_bit_reader_t reader = {frame, 64, (length - 2) * 8};
+  uint8_t widths[TELEMETRY_CHANNELS + 1];
+  for (int c = 0; c <= TELEMETRY_CHANNELS; c++) {
+    uint32_t width;
+    if (telemetry_read_bits(&reader, TELEMETRY_WIDTH_BITS, &width) != 0) {
+      return TELEMETRY_ERR_LENGTH;
+    }
+    widths[c] = (uint8_t)width;
+  }
+
+  int32_t values[TELEMETRY_CHANNELS];
+  if (keyframe) {
+    memset(values, 0, sizeof(values));
+  } else {
+    memcpy(values, dec->reference, sizeof(values));
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    uint32_t field;
+    if (i > 0) {
+      if (telemetry_read_bits(&reader, widths[0], &field) != 0) {
+        return TELEMETRY_ERR_LENGTH;
+      }
+      ms += field;
+    }
+    records[i].timestamp_ns = (uint64_t)ms * 1000000ULL;
+    for (int c = 0; c < TELEMETRY_CHANNELS; c++) {
+      if (telemetry_read_bits(&reader, widths[c + 1], &field) != 0) {
+        return TELEMETRY_ERR_LENGTH;
+      }
+      values[c] += telemetry_unzigzag(field);
+      records[i].values[c] = (float)values[c] * dec->config.resolution[c];
+    }
+  }
+
+  memcpy(dec->reference, values, sizeof(dec->reference));
+  dec->sequence = (uint16_t)(sequence + 1);
+  dec->synced = 1;
+  return (int)count;
+}
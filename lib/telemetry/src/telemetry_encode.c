@@ -0,0 +1,180 @@
+/**
+ * @file telemetry_encode.c
+ * @brief Telemetry frame encoder
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "telemetry_internal.h"
+#include <math.h>
+#include <string.h>
+
+static int32_t telemetry_quantize(float value, float resolution) {
+  float q = roundf(value / resolution);
+  if (!(q < TELEMETRY_QUANT_LIMIT)) {
+    return q != q ? 0 : TELEMETRY_QUANT_LIMIT; // NaN quantizes to 0
+  }
+  if (q < -TELEMETRY_QUANT_LIMIT) {
+    return -TELEMETRY_QUANT_LIMIT;
+  }
+  return (int32_t)q;
+}
+
+/**
+ * @brief Size of a frame holding count records with the given widths
+ */
+static size_t telemetry_frame_bytes(const uint8_t *widths, size_t count) {
+  size_t record_bits = 0;
+  for (int c = 0; c < TELEMETRY_CHANNELS; c++) {
+    record_bits += widths[c + 1];
+  }
+  size_t bits = TELEMETRY_WIDTH_TABLE_BITS + count * record_bits +
+                (count - 1) * widths[0];
+  return TELEMETRY_OVERHEAD_BYTES + (bits + 7) / 8;
+}
+
+/**
+ * @brief Start a new frame with a single record
+ */
+static void telemetry_encoder_open(telemetry_encoder_t *enc, const int32_t *q,
+                                   uint32_t ms) {
+  static const int32_t zero[TELEMETRY_CHANNELS] = {0};
+  enc->keyframe = enc->frames_since_key == 0;
+  const int32_t *ref = enc->keyframe ? zero : enc->reference;
+
+  enc->widths[0] = 0;
+  for (int c = 0; c < TELEMETRY_CHANNELS; c++) {
+    enc->widths[c + 1] = telemetry_bit_width(telemetry_zigzag(q[c] - ref[c]));
+  }
+  memcpy(enc->records[0], q, sizeof(enc->records[0]));
+  enc->timestamps[0] = ms;
+  enc->count = 1;
+}
+
+/**
+ * @brief Serialize the open frame
+ */
+static void telemetry_encoder_emit(telemetry_encoder_t *enc, uint8_t *frame,
+                                   size_t *length) {
+  static const int32_t zero[TELEMETRY_CHANNELS] = {0};
+  size_t bytes = telemetry_frame_bytes(enc->widths, enc->count);
+  memset(frame, 0, bytes);
+
+  frame[0] = (uint8_t)((TELEMETRY_VERSION << 4) |
+                       (enc->keyframe ? TELEMETRY_FLAG_KEYFRAME : 0));
+  frame[1] = (uint8_t)enc->sequence;
+  frame[2] = (uint8_t)(enc->sequence >> 8);
+  frame[3] = (uint8_t)enc->count;
+  for (int i = 0; i < 4; i++) {
+    frame[4 + i] = (uint8_t)(enc->timestamps[0] >> (8 * i));
+  }
+
+  telemetry_bit_writer_t writer = {frame, 64};
+  for (int c = 0; c <= TELEMETRY_CHANNELS; c++) {
+    telemetry_write_bits(&writer, enc->widths[c], TELEMETRY_WIDTH_BITS);
+  }
+
+  const int32_t *prev = enc->keyframe ? zero : enc->reference;
+  for (size_t i = 0; i < enc->count; i++) {
+    if (i > 0) {
+      telemetry_write_bits(&writer, enc->timestamps[i] - enc->timestamps[i - 1],
+                           enc->widths[0]);
+    }
+    for (int c = 0; c < TELEMETRY_CHANNELS; c++) {
+      telemetry_write_bits(&writer,
+                           telemetry_zigzag(enc->records[i][c] - prev[c]),
+                           enc->widths[c + 1]);
+    }
+    prev = enc->records[i];
+  }
+
+  uint16_t crc = telemetry_crc16(frame, bytes - 2);
+  frame[bytes - 2] = (uint8_t)crc;
+  frame[bytes - 1] = (uint8_t)(crc >> 8);
+  *length = bytes;
+
+  memcpy(enc->reference, enc->records[enc->count - 1], sizeof(enc->reference));
+  enc->sequence++;
+  enc->frames_since_key =
+      (uint16_t)((enc->frames_since_key + 1) % enc->config.keyframe_interval);
+  enc->count = 0;
+}
+
+int telemetry_encoder_init(telemetry_encoder_t *enc,
+                           const telemetry_config_t *config) {
+  memset(enc, 0, sizeof(*enc));
+  if (config != NULL) {
+    enc->config = *config;
+  } else {
+    telemetry_default_config(&enc->config);
+  }
+
+  // The worst-case single record must fit, and LoRa caps payloads at 255
+  uint8_t worst[TELEMETRY_CHANNELS + 1];
+  memset(worst, 31, sizeof(worst));
+  if (enc->config.max_payload > 255 ||
+      enc->config.max_payload < telemetry_frame_bytes(worst, 1) ||
+      enc->config.keyframe_interval == 0) {
+    return TELEMETRY_ERR_CONFIG;
+  }
+  for (int c = 0; c < TELEMETRY_CHANNELS; c++) {
+    if (!(enc->config.resolution[c] > 0.0f)) {
+      return TELEMETRY_ERR_CONFIG;
+    }
+  }
+  return 0;
+}
+
+int telemetry_encoder_push(telemetry_encoder_t *enc,
+                           const telemetry_record_t *record, uint8_t *frame,
+                           size_t *length) {
+  int32_t q[TELEMETRY_CHANNELS];
+  for (int c = 0; c < TELEMETRY_CHANNELS; c++) {
+    q[c] = telemetry_quantize(record->values[c], enc->config.resolution[c]);
+  }
+  uint32_t ms = (uint32_t)(record->timestamp_ns / 1000000ULL);
+
+  int emitted = 0;
+  if (enc->count > 0) {
+    uint8_t widths[TELEMETRY_CHANNELS + 1];
+    const int32_t *prev = enc->records[enc->count - 1];
+    uint32_t last = enc->timestamps[enc->count - 1];
+    // A width field holds at most 31 bits: time going backwards (or the
+    // millisecond counter wrapping) and jumps of 2^31 ms start a new frame,
+    // whose header carries the full timestamp
+    int in_range = ms >= last && ms - last <= TELEMETRY_DELTA_LIMIT;
+    uint8_t width = telemetry_bit_width(in_range ? ms - last : 0);
+    widths[0] = width > enc->widths[0] ? width : enc->widths[0];
+    for (int c = 0; c < TELEMETRY_CHANNELS; c++) {
+      width = telemetry_bit_width(telemetry_zigzag(q[c] - prev[c]));
+      widths[c + 1] = width > enc->widths[c + 1] ? width : enc->widths[c + 1];
+    }
+
+    if (in_range && enc->count < TELEMETRY_MAX_RECORDS &&
+        telemetry_frame_bytes(widths, enc->count + 1) <=
+            enc->config.max_payload) {
+      memcpy(enc->records[enc->count], q, sizeof(q));
+      enc->timestamps[enc->count] = ms;
+      memcpy(enc->widths, widths, sizeof(widths));
+      enc->count++;
+      return 0;
+    }
+
+    telemetry_encoder_emit(enc, frame, length);
+    emitted = 1;
+  }
+
+  telemetry_encoder_open(enc, q, ms);
+  return emitted;
+}
+
+int telemetry_encoder_flush(telemetry_encoder_t *enc, uint8_t *frame,
+                            size_t *length) {
+  if (enc->count == 0) {
+    return 0;
+  }
+  telemetry_encoder_emit(enc, frame, length);
+  return 1;
+}
@@ -0,0 +1,102 @@
+/**
+ * @file telemetry_internal.h
+ * @brief Bit packing helpers shared by the telemetry encoder and decoder
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef TELEMETRY_INTERNAL_H
+#define TELEMETRY_INTERNAL_H
+
+#include <telemetry.h>
+
+/** @brief Bits used to store each field width */
+#define TELEMETRY_WIDTH_BITS (5)
+
+/** @brief Bits of the per-frame width table */
+#define TELEMETRY_WIDTH_TABLE_BITS                                             \
+  (TELEMETRY_WIDTH_BITS * (TELEMETRY_CHANNELS + 1))
+
+/** @brief Largest timestamp delta a width field can describe (ms) */
+#define TELEMETRY_DELTA_LIMIT (0x7FFFFFFFUL)
+
+/** @brief Sequence numbers behind the expected one taken as duplicates */
+#define TELEMETRY_REORDER_WINDOW (32)
+
+/** @brief Largest magnitude a quantized value may take */
+#define TELEMETRY_QUANT_LIMIT (0x1FFFFFFF)
+
+/**
+ * @brief MSB-first bit writer over a byte buffer
+ */
+typedef struct {
+  uint8_t *data;   /**< Output buffer */
+  size_t bit;      /**< Next bit position */
+} telemetry_bit_writer_t;
+
+/**
+ * @brief MSB-first bit reader over a byte buffer
+ */
+typedef struct {
+  const uint8_t *data; /**< Input buffer */
+  size_t bit;          /**< Next bit position */
+  size_t limit;        /**< Bits available */
+} telemetry_bit_reader_t;
+
+static inline uint32_t telemetry_zigzag(int32_t value) {
+  return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static inline int32_t telemetry_unzigzag(uint32_t value) {
+  return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+/** @brief Bits needed to store an unsigned value (0 needs 0 bits) */
+static inline uint8_t telemetry_bit_width(uint32_t value) {
+  uint8_t width = 0;
+  while (value != 0) {
+    width++;
+    value >>= 1;
+  }
+  return width;
+}
+
+static inline void telemetry_write_bits(telemetry_bit_writer_t *writer,
+                                        uint32_t value, uint8_t width) {
+  for (int i = width - 1; i >= 0; i--) {
+    size_t byte = writer->bit >> 3;
+    uint8_t mask = (uint8_t)(0x80 >> (writer->bit & 7));
+    if ((value >> i) & 1) {
+      writer->data[byte] |= mask;
+    } else {
+      writer->data[byte] &= (uint8_t)~mask;
+    }
+    writer->bit++;
+  }
+}
+
+/** @return 0 on success, TELEMETRY_ERR_LENGTH if the buffer is exhausted */
+static inline int telemetry_read_bits(telemetry_bit_reader_t *reader,
+                                      uint8_t width, uint32_t *value) {
+  if (reader->bit + width > reader->limit) {
+    return TELEMETRY_ERR_LENGTH;
+  }
+  uint32_t result = 0;
+  for (uint8_t i = 0; i < width; i++) {
+    size_t byte = reader->bit >> 3;
+    uint8_t shift = (uint8_t)(7 - (reader->bit & 7));
+    result = (result << 1) | ((reader->data[byte] >> shift) & 1);
+    reader->bit++;
+  }
+  *value = result;
+  return 0;
+}
+
+/**
+ * @brief CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF)
+ */
+uint16_t telemetry_crc16(const uint8_t *data, size_t length);
+
+#endif // TELEMETRY_INTERNAL_H
@@ -0,0 +1,34 @@
+/**
+ * @file telemetry_sensors.c
+ * @brief Build telemetry records from the driver sample structs
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <telemetry_sensors.h>
+
+void telemetry_record_from_samples(telemetry_record_t *record,
+                                   const bme280_sample_t *env,
+                                   const mpu6050_acce_value_t *acce,
+                                   const mpu6050_gyro_value_t *gyro) {
+  uint64_t timestamp_ns = env->timestamp_ns;
+  if (acce->timestamp_ns > timestamp_ns) {
+    timestamp_ns = acce->timestamp_ns;
+  }
+  if (gyro->timestamp_ns > timestamp_ns) {
+    timestamp_ns = gyro->timestamp_ns;
+  }
+  record->timestamp_ns = timestamp_ns;
+
+  record->values[TELEMETRY_TEMPERATURE] = env->temperature;
+  record->values[TELEMETRY_PRESSURE] = env->pressure;
+  record->values[TELEMETRY_HUMIDITY] = env->humidity;
+  record->values[TELEMETRY_ACCE_X] = acce->acce_x;
+  record->values[TELEMETRY_ACCE_Y] = acce->acce_y;
+  record->values[TELEMETRY_ACCE_Z] = acce->acce_z;
+  record->values[TELEMETRY_GYRO_X] = gyro->gyro_x;
+  record->values[TELEMETRY_GYRO_Y] = gyro->gyro_y;
+  record->values[TELEMETRY_GYRO_Z] = gyro->gyro_z;
+}
@@ -0,0 +1,175 @@
+/**
+ * @file trace.h
+ * @brief Per-thread event tracing with Chrome JSON and binary export
+ *
+ * Trace points are macros that expand to nothing unless COREFLIGHT_TRACE is
+ * defined (configure with -DCOREFLIGHT_TRACE=ON), so the default build
+ * carries no trace code at all.
+ *
+ * When enabled, each thread appends fixed-size events to its own ring
+ * buffer, allocated on its first event. Only the owning thread writes, the
+ * head index is published with release ordering, and recording an event is
+ * one clock read plus a few stores. When a ring wraps, the oldest events are
+ * overwritten. Buffers stay registered after their thread exits so the
+ * events can still be exported.
+ *
+ *   TRACE_BEGIN(read);
+ *   bme280_read_sample(&env);
+ *   TRACE_END(read, "bme280_read_sample", 0);
+ *
+ * Event names must be string literals or otherwise outlive the export.
+ * Export while the traced threads are quiet: events being overwritten
+ * during the export may come out torn.
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+/** @brief Binary export magic ("CFTR") */
+#define TRACE_MAGIC (0x52544643UL)
+
+/** @brief Binary export format version */
+#define TRACE_VERSION (1)
+
+/** @brief Events per thread unless trace_configure() says otherwise */
+#define TRACE_DEFAULT_EVENTS (65536)
+
+/** @brief Duration marking an instant event */
+#define TRACE_INSTANT_DUR (UINT32_MAX)
+
+/** @brief Longest thread name kept */
+#define TRACE_THREAD_NAME_MAX (24)
+
+/**
+ * @brief Event as recorded in the per-thread ring
+ */
+typedef struct {
+  const char *name; /**< Static event name */
+  uint64_t ts_ns;   /**< Start, CLOCK_MONOTONIC */
+  uint32_t dur_ns;  /**< Duration, TRACE_INSTANT_DUR for instants */
+  uint32_t arg;     /**< Free-form argument (register, count, size) */
+} trace_event_t;
+
+/**
+ * @brief Binary export layout
+ *
+ * Little-endian, in order: trace_file_header_t, string_count strings each
+ * as a uint16_t length and the bytes without terminator, thread_count
+ * trace_file_thread_t, event_count trace_file_event_t sorted by thread and
+ * then time.
+ */
+typedef struct {
+  uint32_t magic;        /**< TRACE_MAGIC */
+  uint16_t version;      /**< TRACE_VERSION */
+  uint16_t reserved;     /**< Zero */
+  uint32_t string_count; /**< Entries in the string table */
+  uint32_t thread_count; /**< Entries in the thread table */
+  uint64_t event_count;  /**< Events that follow */
+} trace_file_header_t;
+
+/**
+ * @brief Thread table entry of the binary export
+ */
+typedef struct {
+  uint32_t tid;  /**< Trace thread number */
+  uint32_t name; /**< String index, UINT32_MAX if unnamed */
+} trace_file_thread_t;
+
+/**
+ * @brief Event of the binary export
+ */
+typedef struct {
+  uint64_t ts_ns;  /**< Start, CLOCK_MONOTONIC */
+  uint32_t dur_ns; /**< Duration, TRACE_INSTANT_DUR for instants */
+  uint32_t arg;    /**< Event argument */
+  uint32_t name;   /**< String index */
+  uint32_t tid;    /**< Trace thread number */
+} trace_file_event_t;
+
+/**
+ * @brief Monotonic clock used for event timestamps
+ * @return Nanoseconds
+ */
+static inline uint64_t trace_now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Set the ring size of threads that have not traced yet
+ * @param events Events per thread, rounded up to a power of two
+ */
+void trace_configure(size_t events);
+
+/**
+ * @brief Record an event that started at begin_ns and ends now
+ * @param name Event name
+ * @param begin_ns Start from trace_now_ns()
+ * @param arg Event argument
+ */
+void trace_complete(const char *name, uint64_t begin_ns, uint32_t arg);
+
+/**
+ * @brief Record an instant event
+ * @param name Event name
+ * @param arg Event argument
+ */
+void trace_instant(const char *name, uint32_t arg);
+
+/**
+ * @brief Name the calling thread in the exported trace
+ * @param name Thread name, copied
+ */
+void trace_thread_name(const char *name);
+
+/**
+ * @brief Write every buffered event as Chrome trace-event JSON
+ *
+ * Opens in chrome://tracing or Perfetto. Timestamps are in microseconds
+ * with nanosecond decimals.
+ *
+ * @param path Output file
+ * @return 0 on success, -1 on I/O error
+ */
+int trace_export_json(const char *path);
+
+/**
+ * @brief Write every buffered event in the binary layout above
+ * @param path Output file
+ * @return 0 on success, -1 on I/O or allocation error
+ */
+int trace_export_binary(const char *path);
+
+#ifdef COREFLIGHT_TRACE
+#define TRACE_BEGIN(scope) const uint64_t trace_begin_##scope = trace_now_ns()
+#define TRACE_END(scope, name, arg)                                            \
+  trace_complete((name), trace_begin_##scope, (uint32_t)(arg))
+#define TRACE_INSTANT(name, arg) trace_instant((name), (uint32_t)(arg))
+#define TRACE_THREAD_NAME(name) trace_thread_name(name)
+#define TRACE_EXPORT_JSON(path) trace_export_json(path)
+#define TRACE_EXPORT_BINARY(path) trace_export_binary(path)
+#else
+#define TRACE_BEGIN(scope) ((void)0)
+#define TRACE_END(scope, name, arg) ((void)0)
+#define TRACE_INSTANT(name, arg) ((void)0)
+#define TRACE_THREAD_NAME(name) ((void)0)
+#define TRACE_EXPORT_JSON(path) ((void)0)
+#define TRACE_EXPORT_BINARY(path) ((void)0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif // TRACE_H
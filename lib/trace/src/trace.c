@@ -0,0 +1,256 @@
+/**
+ * @file trace.c
+ * @brief Per-thread event tracing with Chrome JSON and binary export
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <trace.h>
+
+/**
+ * @brief Ring of one thread, written by that thread only
+ */
+typedef struct trace_buffer {
+  struct trace_buffer *next;         /**< Next registered buffer */
+  uint32_t tid;                      /**< Trace thread number */
+  char name[TRACE_THREAD_NAME_MAX];  /**< Thread name, empty if unset */
+  size_t mask;                       /**< Capacity - 1 */
+  _Atomic uint64_t head;             /**< Events ever written */
+  trace_event_t events[];            /**< Ring storage */
+} trace_buffer_t;
+
+static _Atomic(trace_buffer_t *) buffers = NULL;
+static atomic_uint next_tid = 1;
+static atomic_size_t capacity = TRACE_DEFAULT_EVENTS;
+static _Thread_local trace_buffer_t *local = NULL;
+static _Thread_local int local_failed = 0;
+
+void trace_configure(size_t events) {
+  size_t n = 1;
+  while (n < events) {
+    n <<= 1;
+  }
+  atomic_store(&capacity, n);
+}
+
+static trace_buffer_t *trace_local(void) {
+  if (local != NULL || local_failed) {
+    return local;
+  }
+  size_t n = atomic_load(&capacity);
+  trace_buffer_t *b = malloc(sizeof(*b) + n * sizeof(trace_event_t));
+  if (b == NULL) {
+    // Stay silent and untraced rather than retrying on every event
+    local_failed = 1;
+    return NULL;
+  }
+  b->tid = atomic_fetch_add(&next_tid, 1);
+  b->name[0] = '\0';
+  b->mask = n - 1;
+  atomic_init(&b->head, 0);
+
+  trace_buffer_t *first = atomic_load(&buffers);
+  do {
+    b->next = first;
+  } while (!atomic_compare_exchange_weak(&buffers, &first, b));
+  local = b;
+  return b;
+}
+
+static void trace_record(const char *name, uint64_t ts_ns, uint32_t dur_ns,
+                         uint32_t arg) {
+  trace_buffer_t *b = trace_local();
+  if (b == NULL) {
+    return;
+  }
+  uint64_t head = atomic_load_explicit(&b->head, memory_order_relaxed);
+  trace_event_t *e = &b->events[head & b->mask];
+  e->name = name;
+  e->ts_ns = ts_ns;
+  e->dur_ns = dur_ns;
+  e->arg = arg;
+  atomic_store_explicit(&b->head, head + 1, memory_order_release);
+}
+
+void trace_complete(const char *name, uint64_t begin_ns, uint32_t arg) {
+  uint64_t dur = trace_now_ns() - begin_ns;
+  trace_record(name, begin_ns,
+               dur < TRACE_INSTANT_DUR ? (uint32_t)dur : TRACE_INSTANT_DUR - 1,
+               arg);
+}
+
+void trace_instant(const char *name, uint32_t arg) {
+  trace_record(name, trace_now_ns(), TRACE_INSTANT_DUR, arg);
+}
+
+void trace_thread_name(const char *name) {
+  trace_buffer_t *b = trace_local();
+  if (b != NULL) {
+    snprintf(b->name, sizeof(b->name), "%s", name);
+  }
+}
+
+/**
+ * @brief Oldest retained event number of a buffer and the end of the range
+ */
+static uint64_t trace_range(trace_buffer_t *b, uint64_t *end) {
+  *end = atomic_load_explicit(&b->head, memory_order_acquire);
+  return *end > b->mask + 1 ? *end - (b->mask + 1) : 0;
+}
+
+static void trace_json_string(FILE *f, const char *s) {
+  fputc('"', f);
+  for (; *s != '\0'; s++) {
+    if (*s == '"' || *s == '\\') {
+      fputc('\\', f);
+    }
+    if ((unsigned char)*s >= 0x20) {
+      fputc(*s, f);
+    }
+  }
+  fputc('"', f);
+}
+
+int trace_export_json(const char *path) {
+  FILE *f = fopen(path, "w");
+  if (f == NULL) {
+    fprintf(stderr, "Error opening trace file %s\n", path);
+    return -1;
+  }
+  fprintf(f, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+  int first = 1;
+  for (trace_buffer_t *b = atomic_load(&buffers); b != NULL; b = b->next) {
+    if (b->name[0] != '\0') {
+      fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                 "\"tid\":%u,\"args\":{\"name\":",
+              first ? "" : ",\n", b->tid);
+      trace_json_string(f, b->name);
+      fprintf(f, "}}");
+      first = 0;
+    }
+    uint64_t end;
+    for (uint64_t i = trace_range(b, &end); i < end; i++) {
+      const trace_event_t *e = &b->events[i & b->mask];
+      fprintf(f, "%s{\"name\":", first ? "" : ",\n");
+      trace_json_string(f, e->name);
+      fprintf(f, ",\"pid\":1,\"tid\":%u,\"ts\":%llu.%03u", b->tid,
+              (unsigned long long)(e->ts_ns / 1000),
+              (unsigned)(e->ts_ns % 1000));
+      if (e->dur_ns == TRACE_INSTANT_DUR) {
+        fprintf(f, ",\"ph\":\"i\",\"s\":\"t\"");
+      } else {
+        fprintf(f, ",\"ph\":\"X\",\"dur\":%u.%03u", e->dur_ns / 1000,
+                e->dur_ns % 1000);
+      }
+      fprintf(f, ",\"args\":{\"arg\":%u}}", e->arg);
+      first = 0;
+    }
+  }
+  fprintf(f, "\n]}\n");
+  return fclose(f) == 0 ? 0 : -1;
+}
+
+/**
+ * @brief String table built during the binary export
+ */
+typedef struct {
+  const char **items; /**< Distinct strings */
+  uint32_t count;     /**< Entries used */
+  uint32_t size;      /**< Entries allocated */
+} trace_strings_t;
+
+static uint32_t trace_intern(trace_strings_t *t, const char *s) {
+  for (uint32_t i = 0; i < t->count; i++) {
+    if (t->items[i] == s || strcmp(t->items[i], s) == 0) {
+      return i;
+    }
+  }
+  if (t->count == t->size) {
+    uint32_t size = t->size != 0 ? t->size * 2 : 64;
+    const char **items = realloc(t->items, size * sizeof(*items));
+    if (items == NULL) {
+      return UINT32_MAX;
+    }
+    t->items = items;
+    t->size = size;
+  }
+  t->items[t->count] = s;
+  return t->count++;
+}
+
+static int trace_write_binary(FILE *f, trace_buffer_t *list, size_t threads,
+                              uint64_t *ranges, uint32_t *names,
+                              trace_strings_t *strings) {
+  trace_file_header_t header = {TRACE_MAGIC, TRACE_VERSION, 0, 0, 0, 0};
+  size_t t = 0;
+  for (trace_buffer_t *b = list; b != NULL; b = b->next, t++) {
+    ranges[2 * t] = trace_range(b, &ranges[2 * t + 1]);
+    header.event_count += ranges[2 * t + 1] - ranges[2 * t];
+    names[t] =
+        b->name[0] != '\0' ? trace_intern(strings, b->name) : UINT32_MAX;
+    for (uint64_t i = ranges[2 * t]; i < ranges[2 * t + 1]; i++) {
+      if (trace_intern(strings, b->events[i & b->mask].name) == UINT32_MAX) {
+        return -1;
+      }
+    }
+  }
+  header.string_count = strings->count;
+  header.thread_count = (uint32_t)threads;
+
+  fwrite(&header, sizeof(header), 1, f);
+  for (uint32_t i = 0; i < strings->count; i++) {
+    size_t len = strlen(strings->items[i]);
+    uint16_t n = len < UINT16_MAX ? (uint16_t)len : UINT16_MAX;
+    fwrite(&n, sizeof(n), 1, f);
+    fwrite(strings->items[i], 1, n, f);
+  }
+  t = 0;
+  for (trace_buffer_t *b = list; b != NULL; b = b->next, t++) {
+    trace_file_thread_t entry = {b->tid, names[t]};
+    fwrite(&entry, sizeof(entry), 1, f);
+  }
+  t = 0;
+  for (trace_buffer_t *b = list; b != NULL; b = b->next, t++) {
+    for (uint64_t i = ranges[2 * t]; i < ranges[2 * t + 1]; i++) {
+      const trace_event_t *e = &b->events[i & b->mask];
+      trace_file_event_t out = {e->ts_ns, e->dur_ns, e->arg,
+                                trace_intern(strings, e->name), b->tid};
+      fwrite(&out, sizeof(out), 1, f);
+    }
+  }
+  return ferror(f) ? -1 : 0;
+}
+
+int trace_export_binary(const char *path) {
+  // Buffers are only ever prepended, so this list stays the same during the
+  // export, and the ranges are snapshotted so the counts match the events
+  trace_buffer_t *list = atomic_load(&buffers);
+  size_t threads = 0;
+  for (trace_buffer_t *b = list; b != NULL; b = b->next) {
+    threads++;
+  }
+
+  trace_strings_t strings = {NULL, 0, 0};
+  uint64_t *ranges = calloc(2 * threads + 1, sizeof(uint64_t));
+  uint32_t *names = calloc(threads + 1, sizeof(uint32_t));
+  FILE *f = fopen(path, "wb");
+  int ret = -1;
+  if (ranges == NULL || names == NULL || f == NULL) {
+    fprintf(stderr, "Error opening trace file %s\n", path);
+  } else {
+    ret = trace_write_binary(f, list, threads, ranges, names, &strings);
+  }
+  if (f != NULL && fclose(f) != 0) {
+    ret = -1;
+  }
+  free(strings.items);
+  free(ranges);
+  free(names);
+  return ret;
+}
@@ -0,0 +1,104 @@
+/**
+ * @file vertical_kf.h
+ * @brief Barometer + accelerometer vertical channel Kalman filter
+ *
+ * Estimates altitude, vertical velocity and vertical accelerometer bias. The
+ * filter predicts at the MPU6050 rate from gravity-compensated Z
+ * acceleration and corrects with the BME280 barometric altitude whenever a
+ * new pressure sample is available. The state is a fixed 3-vector with a
+ * 3x3 covariance: no allocation, constant time per call.
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef VERTICAL_KF_H
+#define VERTICAL_KF_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "bme280.h"
+#include "mpu6050.h"
+
+/** @brief Standard gravity in m/s^2 */
+#define VERTICAL_KF_GRAVITY (9.80665f)
+
+/** @brief Largest prediction step accepted between two IMU samples (s) */
+#define VERTICAL_KF_MAX_DT_S (0.5f)
+
+/**
+ * @brief Filter tuning
+ */
+typedef struct {
+  float accel_noise;    /**< Vertical acceleration noise (m/s^2) */
+  float bias_noise;     /**< Accelerometer bias random walk (m/s^2/sqrt(s)) */
+  float baro_noise;     /**< Barometric altitude noise (m) */
+  float sea_level_hpa;  /**< Sea-level pressure for the altitude formula */
+} vertical_kf_config_t;
+
+/**
+ * @brief Filter state
+ */
+typedef struct {
+  vertical_kf_config_t config; /**< Active tuning */
+  float x[3];                  /**< Altitude (m), velocity (m/s), bias */
+  float P[3][3];               /**< State covariance */
+  uint64_t imu_ns;             /**< Timestamp of the last prediction */
+  uint64_t baro_ns;            /**< Timestamp of the last correction */
+  int initialized;             /**< Non-zero once seeded by the barometer */
+} vertical_kf_t;
+
+/**
+ * @brief Fill a configuration with sensible defaults
+ * @param config Configuration to fill
+ */
+void vertical_kf_default_config(vertical_kf_config_t *config);
+
+/**
+ * @brief Initialize the filter
+ * @param kf Filter state
+ * @param config Tuning, or NULL for the defaults
+ */
+void vertical_kf_init(vertical_kf_t *kf, const vertical_kf_config_t *config);
+
+/**
+ * @brief Propagate the state with one accelerometer sample
+ * @param kf Filter state
+ * @param acce Accelerometer sample in g
+ * @param angle Current roll/pitch in degrees, or NULL if the board is level
+ */
+void vertical_kf_predict(vertical_kf_t *kf, const mpu6050_acce_value_t *acce,
+                         const complimentary_angle_t *angle);
+
+/**
+ * @brief Correct the state with a barometer sample
+ *
+ * Samples not newer than the previous correction are ignored, so the
+ * acquisition loop can pass its latest BME280 sample on every iteration.
+ *
+ * @param kf Filter state
+ * @param sample BME280 sample
+ * @return 1 if the sample was used, 0 if it was not new
+ */
+int vertical_kf_correct(vertical_kf_t *kf, const bme280_sample_t *sample);
+
+/**
+ * @brief Current altitude estimate
+ * @param kf Filter state
+ * @return Altitude in meters
+ */
+float vertical_kf_altitude(const vertical_kf_t *kf);
+
+/**
+ * @brief Current vertical velocity estimate
+ * @param kf Filter state
+ * @return Velocity in m/s, positive upwards
+ */
+float vertical_kf_velocity(const vertical_kf_t *kf);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // VERTICAL_KF_H
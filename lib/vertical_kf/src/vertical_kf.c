@@ -0,0 +1,154 @@
+/**
+ * @file vertical_kf.c
+ * @brief Implementation of the vertical channel Kalman filter
+ *
+ * State x = [h, v, b]: altitude, vertical velocity and accelerometer bias.
+ * Prediction uses a = a_z - b as the control input; the barometer observes
+ * h directly, so the correction is a scalar update.
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <math.h>
+#include <string.h>
+#include <vertical_kf.h>
+
+#define VERTICAL_KF_DEG_TO_RAD (3.14159265358979f / 180.0f)
+
+/** @brief Initial velocity uncertainty (m/s) */
+#define VERTICAL_KF_INITIAL_VELOCITY_STD (1.0f)
+
+/** @brief Initial accelerometer bias uncertainty (m/s^2) */
+#define VERTICAL_KF_INITIAL_BIAS_STD (0.5f)
+
+/**
+ * @brief Barometric altitude, same formula as bme280_read_altitude()
+ */
+static float vertical_kf_baro_altitude(const vertical_kf_t *kf,
+                                       float pressure_pa) {
+  float atmospheric = pressure_pa / 100.0f;
+  return 44330.0f *
+         (1.0f - powf(atmospheric / kf->config.sea_level_hpa, 0.1903f));
+}
+
+void vertical_kf_default_config(vertical_kf_config_t *config) {
+  config->accel_noise = 0.5f;
+  config->bias_noise = 0.01f;
+  config->baro_noise = 0.5f;
+  config->sea_level_hpa = SEALEVELPRESSURE_HPA;
+}
+
+void vertical_kf_init(vertical_kf_t *kf, const vertical_kf_config_t *config) {
+  if (config != NULL) {
+    kf->config = *config;
+  } else {
+    vertical_kf_default_config(&kf->config);
+  }
+  memset(kf->x, 0, sizeof(kf->x));
+  memset(kf->P, 0, sizeof(kf->P));
+  kf->imu_ns = 0;
+  kf->baro_ns = 0;
+  kf->initialized = 0;
+}
+
+void vertical_kf_predict(vertical_kf_t *kf, const mpu6050_acce_value_t *acce,
+                         const complimentary_angle_t *angle) {
+  uint64_t last_ns = kf->imu_ns;
+  if (acce->timestamp_ns <= last_ns) {
+    return;
+  }
+  kf->imu_ns = acce->timestamp_ns;
+  if (!kf->initialized || last_ns == 0) {
+    return;
+  }
+  float dt = (float)(acce->timestamp_ns - last_ns) * 1e-9f;
+  if (dt > VERTICAL_KF_MAX_DT_S) {
+    return;
+  }
+
+  // Project the specific force onto the world vertical and remove gravity
+  float up = acce->acce_z;
+  if (angle != NULL) {
+    float roll = angle->roll * VERTICAL_KF_DEG_TO_RAD;
+    float pitch = angle->pitch * VERTICAL_KF_DEG_TO_RAD;
+    float cos_pitch = cosf(pitch);
+    up = -sinf(pitch) * acce->acce_x + sinf(roll) * cos_pitch * acce->acce_y +
+         cosf(roll) * cos_pitch * acce->acce_z;
+  }
+  float a = (up - 1.0f) * VERTICAL_KF_GRAVITY - kf->x[2];
+
+  float dt2 = dt * dt;
+  kf->x[0] += kf->x[1] * dt + 0.5f * a * dt2;
+  kf->x[1] += a * dt;
+
+  // P = F P F' + Q with F = [1 dt -dt^2/2; 0 1 -dt; 0 0 1]
+  float (*P)[3] = kf->P;
+  float h = -0.5f * dt2;
+  float FP[3][3];
+  for (int j = 0; j < 3; j++) {
+    FP[0][j] = P[0][j] + dt * P[1][j] + h * P[2][j];
+    FP[1][j] = P[1][j] - dt * P[2][j];
+    FP[2][j] = P[2][j];
+  }
+  for (int i = 0; i < 3; i++) {
+    P[i][0] = FP[i][0] + dt * FP[i][1] + h * FP[i][2];
+    P[i][1] = FP[i][1] - dt * FP[i][2];
+    P[i][2] = FP[i][2];
+  }
+
+  float qa = kf->config.accel_noise * kf->config.accel_noise;
+  float qb = kf->config.bias_noise * kf->config.bias_noise;
+  P[0][0] += qa * dt2 * dt2 * 0.25f;
+  P[0][1] += qa * dt2 * dt * 0.5f;
+  P[1][0] += qa * dt2 * dt * 0.5f;
+  P[1][1] += qa * dt2;
+  P[2][2] += qb * dt;
+}
+
+int vertical_kf_correct(vertical_kf_t *kf, const bme280_sample_t *sample) {
+  if (sample->timestamp_ns <= kf->baro_ns || sample->pressure <= 0.0f) {
+    return 0;
+  }
+  kf->baro_ns = sample->timestamp_ns;
+
+  float altitude = vertical_kf_baro_altitude(kf, sample->pressure);
+  float r = kf->config.baro_noise * kf->config.baro_noise;
+
+  if (!kf->initialized) {
+    kf->x[0] = altitude;
+    kf->x[1] = 0.0f;
+    kf->x[2] = 0.0f;
+    memset(kf->P, 0, sizeof(kf->P));
+    kf->P[0][0] = r;
+    kf->P[1][1] =
+        VERTICAL_KF_INITIAL_VELOCITY_STD * VERTICAL_KF_INITIAL_VELOCITY_STD;
+    kf->P[2][2] = VERTICAL_KF_INITIAL_BIAS_STD * VERTICAL_KF_INITIAL_BIAS_STD;
+    kf->initialized = 1;
+    return 1;
+  }
+
+  // H = [1 0 0]: innovation covariance is P00 + R, gain is column 0 of P
+  float (*P)[3] = kf->P;
+  float innovation = altitude - kf->x[0];
+  float s = P[0][0] + r;
+  float k[3] = {P[0][0] / s, P[1][0] / s, P[2][0] / s};
+
+  kf->x[0] += k[0] * innovation;
+  kf->x[1] += k[1] * innovation;
+  kf->x[2] += k[2] * innovation;
+
+  // P = (I - K H) P, only row 0 of P feeds the update
+  float row0[3] = {P[0][0], P[0][1], P[0][2]};
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      P[i][j] -= k[i] * row0[j];
+    }
+  }
+  return 1;
+}
+
+float vertical_kf_altitude(const vertical_kf_t *kf) { return kf->x[0]; }
+
+float vertical_kf_velocity(const vertical_kf_t *kf) { return kf->x[1]; }
@@ -0,0 +1,220 @@
+/**
+ * @file window_stats.h
+ * @brief Sliding-window min/max/mean/stddev per channel in O(1)
+ *
+ * Every channel keeps one ring of timestamped samples, sized for the
+ * longest window, and tracks one window per configured length (for example
+ * the last 1 s, 10 s and 60 s) as a cursor into that ring: the oldest
+ * sample the window still covers, running sums for mean and variance and
+ * two monotonic deques for min and max. A push or an expiry costs O(1)
+ * amortised and a query is a few loads. All memory is allocated by
+ * window_stats_init(): channels * capacity * (12 + 8 * windows) bytes.
+ *
+ * Samples older than the window length are expired on push and on query.
+ * When samples arrive faster than the capacity allows, the oldest ones are
+ * dropped early and the longest windows cover less time; size the capacity
+ * as the longest window length times the highest sample rate.
+ *
+ * Feed it whatever the drivers produce, e.g. temperature, pressure and
+ * humidity of a bme280_sample_t as channels 0-2 with
+ * window_stats_push_frame().
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef WINDOW_STATS_H
+#define WINDOW_STATS_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** @brief Maximum window lengths per channel */
+#define WINDOW_STATS_MAX_WINDOWS (4)
+
+/**
+ * @brief Statistics of one channel over one window
+ */
+typedef struct {
+  uint64_t window_ns; /**< Configured window length */
+  uint32_t count;     /**< Samples in the window, 0 if empty */
+  float min;          /**< Smallest sample */
+  float max;          /**< Largest sample */
+  float mean;         /**< Arithmetic mean */
+  float stddev;       /**< Population standard deviation */
+} window_stats_summary_t;
+
+/**
+ * @brief One window of one channel, a cursor into the channel ring
+ *
+ * The deques hold the low 32 bits of sample numbers; a window never spans
+ * more than capacity samples, so the full number is recovered from the
+ * channel tail.
+ */
+typedef struct {
+  uint64_t length_ns; /**< Window length */
+  uint32_t *min_seq;  /**< Increasing-value deque of sample numbers */
+  uint32_t *max_seq;  /**< Decreasing-value deque of sample numbers */
+  uint64_t head;      /**< Number of the oldest sample in the window */
+  size_t min_head;    /**< Front of min_seq */
+  size_t min_len;     /**< Entries in min_seq */
+  size_t max_head;    /**< Front of max_seq */
+  size_t max_len;     /**< Entries in max_seq */
+  double sum;         /**< Sum of (value - offset) */
+  double sum_sq;      /**< Sum of (value - offset)^2 */
+  float offset;       /**< First sample, keeps the sums well conditioned */
+  int has_offset;     /**< Offset set, cleared when the window empties */
+} window_stats_window_t;
+
+/**
+ * @brief Sample ring of one channel, shared by all its windows
+ */
+typedef struct {
+  uint64_t *times; /**< Sample timestamps, ring of capacity */
+  float *values;   /**< Sample values, ring of capacity */
+  uint64_t tail;   /**< Number of the next sample */
+  window_stats_window_t window[WINDOW_STATS_MAX_WINDOWS]; /**< Windows */
+} window_stats_channel_t;
+
+/**
+ * @brief Aggregator state
+ */
+typedef struct {
+  size_t channels;                 /**< Channels */
+  size_t windows;                  /**< Windows per channel */
+  size_t capacity;                 /**< Samples per channel ring */
+  window_stats_channel_t *channel; /**< One per channel */
+  void *memory;                    /**< Backing allocation */
+} window_stats_t;
+
+/**
+ * @brief Threshold test on one statistic
+ */
+typedef enum {
+  WINDOW_STATS_MIN_BELOW,    /**< min < threshold */
+  WINDOW_STATS_MAX_ABOVE,    /**< max > threshold */
+  WINDOW_STATS_MEAN_BELOW,   /**< mean < threshold */
+  WINDOW_STATS_MEAN_ABOVE,   /**< mean > threshold */
+  WINDOW_STATS_STDDEV_ABOVE, /**< stddev > threshold */
+  WINDOW_STATS_SPAN_ABOVE    /**< max - min > threshold */
+} window_stats_test_t;
+
+/**
+ * @brief Threshold alarm on a channel window
+ */
+typedef struct {
+  size_t channel;           /**< Channel index */
+  size_t window;            /**< Window index */
+  window_stats_test_t test; /**< Condition */
+  float threshold;          /**< Limit */
+  uint32_t min_count;       /**< Samples needed before the alarm can fire */
+} window_stats_alarm_t;
+
+/**
+ * @brief Allocate the aggregator
+ * @param ws Aggregator
+ * @param channels Number of channels
+ * @param window_ns Window lengths, shared by all channels
+ * @param windows Number of lengths, 1..WINDOW_STATS_MAX_WINDOWS
+ * @param capacity Most samples the longest window holds, below 2^32
+ * @return 0 on success, -1 on invalid arguments or allocation failure
+ */
+int window_stats_init(window_stats_t *ws, size_t channels,
+                      const uint64_t *window_ns, size_t windows,
+                      size_t capacity);
+
+/**
+ * @brief Add a sample to every window of a channel
+ * @param ws Aggregator
+ * @param channel Channel index
+ * @param timestamp_ns Sample time, non-decreasing per channel
+ * @param value Sample value
+ */
+void window_stats_push(window_stats_t *ws, size_t channel,
+                       uint64_t timestamp_ns, float value);
+
+/**
+ * @brief Add one sample to each of count consecutive channels
+ * @param ws Aggregator
+ * @param first Index of the first channel
+ * @param timestamp_ns Sample time
+ * @param values count values
+ * @param count Number of channels
+ */
+void window_stats_push_frame(window_stats_t *ws, size_t first,
+                             uint64_t timestamp_ns, const float *values,
+                             size_t count);
+
+/**
+ * @brief Statistics of one channel window
+ * @param ws Aggregator
+ * @param channel Channel index
+ * @param window Window index
+ * @param now_ns Current time, samples older than the window are expired
+ * @param summary Destination
+ */
+void window_stats_get(window_stats_t *ws, size_t channel, size_t window,
+                      uint64_t now_ns, window_stats_summary_t *summary);
+
+/**
+ * @brief Statistics of every channel and window
+ * @param ws Aggregator
+ * @param now_ns Current time
+ * @param summary channels * windows entries, channel-major
+ */
+void window_stats_snapshot(window_stats_t *ws, uint64_t now_ns,
+                           window_stats_summary_t *summary);
+
+/**
+ * @brief Fill in an alarm, checking it against the aggregator
+ * @param ws Aggregator the alarm will be checked against
+ * @param alarm Destination
+ * @param channel Channel index
+ * @param window Window index
+ * @param test Condition
+ * @param threshold Limit
+ * @param min_count Samples needed before the alarm can fire
+ * @return 0 on success, -1 if channel, window or test is out of range
+ */
+int window_stats_alarm_set(const window_stats_t *ws,
+                           window_stats_alarm_t *alarm, size_t channel,
+                           size_t window, window_stats_test_t test,
+                           float threshold, uint32_t min_count);
+
+/**
+ * @brief Evaluate alarms against a snapshot
+ *
+ * Alarms whose channel or window is out of range never fire.
+ *
+ * @param ws Aggregator the snapshot was taken from
+ * @param summary Snapshot from window_stats_snapshot()
+ * @param alarms Alarm table
+ * @param count Number of alarms
+ * @param fired Optional, set to 1 for each alarm that fired and 0 otherwise
+ * @return Number of alarms that fired
+ */
+size_t window_stats_check(const window_stats_t *ws,
+                          const window_stats_summary_t *summary,
+                          const window_stats_alarm_t *alarms, size_t count,
+                          uint8_t *fired);
+
+/**
+ * @brief Empty every window
+ * @param ws Aggregator
+ */
+void window_stats_reset(window_stats_t *ws);
+
+/**
+ * @brief Release the aggregator memory
+ * @param ws Aggregator
+ */
+void window_stats_free(window_stats_t *ws);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // WINDOW_STATS_H
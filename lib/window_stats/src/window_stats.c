@@ -0,0 +1,280 @@
+/**
+ * @file window_stats.c
+ * @brief Sliding-window min/max/mean/stddev per channel in O(1)
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <window_stats.h>
+
+int window_stats_init(window_stats_t *ws, size_t channels,
+                      const uint64_t *window_ns, size_t windows,
+                      size_t capacity) {
+  memset(ws, 0, sizeof(*ws));
+  if (channels == 0 || windows == 0 || windows > WINDOW_STATS_MAX_WINDOWS ||
+      capacity == 0 || capacity > UINT32_MAX) {
+    return -1;
+  }
+  // Channel structs, then the timestamp rings, the value rings and the
+  // 32-bit deques, so each array stays aligned to its element size
+  const size_t slots = channels * capacity;
+  const size_t bytes = channels * sizeof(window_stats_channel_t) +
+                       slots * (sizeof(uint64_t) + sizeof(float)) +
+                       slots * windows * 2 * sizeof(uint32_t);
+  uint8_t *memory = malloc(bytes);
+  if (memory == NULL) {
+    return -1;
+  }
+  ws->channels = channels;
+  ws->windows = windows;
+  ws->capacity = capacity;
+  ws->memory = memory;
+  ws->channel = (window_stats_channel_t *)memory;
+
+  uint64_t *times =
+      (uint64_t *)(memory + channels * sizeof(window_stats_channel_t));
+  float *values = (float *)(times + slots);
+  uint32_t *deques = (uint32_t *)(values + slots);
+  for (size_t c = 0; c < channels; c++) {
+    window_stats_channel_t *ch = &ws->channel[c];
+    memset(ch, 0, sizeof(*ch));
+    ch->times = times + c * capacity;
+    ch->values = values + c * capacity;
+    for (size_t i = 0; i < windows; i++) {
+      window_stats_window_t *w = &ch->window[i];
+      w->length_ns = window_ns[i];
+      w->min_seq = deques + (2 * (c * windows + i) + 0) * capacity;
+      w->max_seq = deques + (2 * (c * windows + i) + 1) * capacity;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Value of a deque entry, whose full sample number lies in
+ * [tail - capacity, tail)
+ */
+static float window_stats_value(const window_stats_channel_t *ch,
+                                size_t capacity, uint32_t entry) {
+  const uint64_t seq = ch->tail - (uint32_t)((uint32_t)ch->tail - entry);
+  return ch->values[seq % capacity];
+}
+
+static void window_stats_evict(window_stats_channel_t *ch,
+                               window_stats_window_t *w, size_t capacity) {
+  const uint64_t seq = w->head;
+  const double d = (double)ch->values[seq % capacity] - w->offset;
+  w->sum -= d;
+  w->sum_sq -= d * d;
+  if (w->min_len != 0 && w->min_seq[w->min_head] == (uint32_t)seq) {
+    w->min_head = w->min_head + 1 == capacity ? 0 : w->min_head + 1;
+    w->min_len--;
+  }
+  if (w->max_len != 0 && w->max_seq[w->max_head] == (uint32_t)seq) {
+    w->max_head = w->max_head + 1 == capacity ? 0 : w->max_head + 1;
+    w->max_len--;
+  }
+  w->head++;
+  if (w->head == ch->tail) {
+    // Empty: drop the rounding error accumulated by the add/subtract pairs
+    // and take the next sample as the new offset
+    w->sum = 0;
+    w->sum_sq = 0;
+    w->has_offset = 0;
+  }
+}
+
+static void window_stats_expire(window_stats_channel_t *ch,
+                                window_stats_window_t *w, size_t capacity,
+                                uint64_t now_ns) {
+  if (now_ns < w->length_ns) {
+    return;
+  }
+  const uint64_t oldest = now_ns - w->length_ns;
+  while (w->head != ch->tail && ch->times[w->head % capacity] <= oldest) {
+    window_stats_evict(ch, w, capacity);
+  }
+}
+
+static void window_stats_add(window_stats_channel_t *ch,
+                             window_stats_window_t *w, size_t capacity,
+                             uint64_t seq, float value) {
+  if (!w->has_offset) {
+    w->offset = value;
+    w->has_offset = 1;
+  }
+  const double d = (double)value - w->offset;
+  w->sum += d;
+  w->sum_sq += d * d;
+
+  // Samples that can no longer be the extreme are dropped from the back
+  while (w->min_len != 0) {
+    size_t back = (w->min_head + w->min_len - 1) % capacity;
+    if (window_stats_value(ch, capacity, w->min_seq[back]) < value) {
+      break;
+    }
+    w->min_len--;
+  }
+  w->min_seq[(w->min_head + w->min_len++) % capacity] = (uint32_t)seq;
+
+  while (w->max_len != 0) {
+    size_t back = (w->max_head + w->max_len - 1) % capacity;
+    if (window_stats_value(ch, capacity, w->max_seq[back]) > value) {
+      break;
+    }
+    w->max_len--;
+  }
+  w->max_seq[(w->max_head + w->max_len++) % capacity] = (uint32_t)seq;
+}
+
+void window_stats_push(window_stats_t *ws, size_t channel,
+                       uint64_t timestamp_ns, float value) {
+  window_stats_channel_t *ch = &ws->channel[channel];
+  const size_t capacity = ws->capacity;
+  const uint64_t seq = ch->tail;
+  for (size_t i = 0; i < ws->windows; i++) {
+    window_stats_window_t *w = &ch->window[i];
+    window_stats_expire(ch, w, capacity, timestamp_ns);
+    // The slot about to be reused still belongs to the windows reaching
+    // back that far
+    if (seq - w->head == capacity) {
+      window_stats_evict(ch, w, capacity);
+    }
+  }
+
+  ch->times[seq % capacity] = timestamp_ns;
+  ch->values[seq % capacity] = value;
+  ch->tail = seq + 1;
+  for (size_t i = 0; i < ws->windows; i++) {
+    window_stats_add(ch, &ch->window[i], capacity, seq, value);
+  }
+}
+
+void window_stats_push_frame(window_stats_t *ws, size_t first,
+                             uint64_t timestamp_ns, const float *values,
+                             size_t count) {
+  for (size_t c = 0; c < count; c++) {
+    window_stats_push(ws, first + c, timestamp_ns, values[c]);
+  }
+}
+
+void window_stats_get(window_stats_t *ws, size_t channel, size_t window,
+                      uint64_t now_ns, window_stats_summary_t *summary) {
+  window_stats_channel_t *ch = &ws->channel[channel];
+  window_stats_window_t *w = &ch->window[window];
+  const size_t capacity = ws->capacity;
+  window_stats_expire(ch, w, capacity, now_ns);
+
+  memset(summary, 0, sizeof(*summary));
+  summary->window_ns = w->length_ns;
+  summary->count = (uint32_t)(ch->tail - w->head);
+  if (summary->count == 0) {
+    return;
+  }
+  const double n = summary->count;
+  const double mean = w->sum / n;
+  const double var = w->sum_sq / n - mean * mean;
+  summary->min = window_stats_value(ch, capacity, w->min_seq[w->min_head]);
+  summary->max = window_stats_value(ch, capacity, w->max_seq[w->max_head]);
+  summary->mean = (float)(w->offset + mean);
+  summary->stddev = var > 0 ? (float)sqrt(var) : 0.0f;
+}
+
+void window_stats_snapshot(window_stats_t *ws, uint64_t now_ns,
+                           window_stats_summary_t *summary) {
+  for (size_t c = 0; c < ws->channels; c++) {
+    for (size_t i = 0; i < ws->windows; i++) {
+      window_stats_get(ws, c, i, now_ns, &summary[c * ws->windows + i]);
+    }
+  }
+}
+
+int window_stats_alarm_set(const window_stats_t *ws,
+                           window_stats_alarm_t *alarm, size_t channel,
+                           size_t window, window_stats_test_t test,
+                           float threshold, uint32_t min_count) {
+  if (channel >= ws->channels || window >= ws->windows ||
+      (unsigned)test > WINDOW_STATS_SPAN_ABOVE) {
+    fprintf(stderr, "Error alarm on channel %zu window %zu is out of range\n",
+            channel, window);
+    return -1;
+  }
+  alarm->channel = channel;
+  alarm->window = window;
+  alarm->test = test;
+  alarm->threshold = threshold;
+  alarm->min_count = min_count;
+  return 0;
+}
+
+size_t window_stats_check(const window_stats_t *ws,
+                          const window_stats_summary_t *summary,
+                          const window_stats_alarm_t *alarms, size_t count,
+                          uint8_t *fired) {
+  size_t total = 0;
+  for (size_t i = 0; i < count; i++) {
+    const window_stats_alarm_t *a = &alarms[i];
+    int hit = 0;
+    if (a->channel >= ws->channels || a->window >= ws->windows) {
+      if (fired != NULL) {
+        fired[i] = 0;
+      }
+      continue;
+    }
+    const window_stats_summary_t *s =
+        &summary[a->channel * ws->windows + a->window];
+    if (s->count != 0 && s->count >= a->min_count) {
+      switch (a->test) {
+      case WINDOW_STATS_MIN_BELOW:
+        hit = s->min < a->threshold;
+        break;
+      case WINDOW_STATS_MAX_ABOVE:
+        hit = s->max > a->threshold;
+        break;
+      case WINDOW_STATS_MEAN_BELOW:
+        hit = s->mean < a->threshold;
+        break;
+      case WINDOW_STATS_MEAN_ABOVE:
+        hit = s->mean > a->threshold;
+        break;
+      case WINDOW_STATS_STDDEV_ABOVE:
+        hit = s->stddev > a->threshold;
+        break;
+      case WINDOW_STATS_SPAN_ABOVE:
+        hit = s->max - s->min > a->threshold;
+        break;
+      }
+    }
+    if (fired != NULL) {
+      fired[i] = (uint8_t)hit;
+    }
+    total += (size_t)hit;
+  }
+  return total;
+}
+
+void window_stats_reset(window_stats_t *ws) {
+  for (size_t c = 0; c < ws->channels; c++) {
+    window_stats_channel_t *ch = &ws->channel[c];
+    ch->tail = 0;
+    for (size_t i = 0; i < ws->windows; i++) {
+      window_stats_window_t *w = &ch->window[i];
+      w->head = 0;
+      w->min_head = w->min_len = 0;
+      w->max_head = w->max_len = 0;
+      w->sum = w->sum_sq = 0;
+      w->has_offset = 0;
+    }
+  }
+}
+
+void window_stats_free(window_stats_t *ws) {
+  free(ws->memory);
+  memset(ws, 0, sizeof(*ws));
+}
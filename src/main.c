@@ -6,17 +6,30 @@
  * @license GNU General Public License v3.0
  */
 
+#include "bringup.h"
 #include "mpu6050.h"
+#include "mpu6050_calib.h"
+#include "sensor_shm_publisher.h"
+#include "telemetry_sensors.h"
+#include "trace.h"
 #include <bme280.h>
+#include <inttypes.h>
 #include <stdio.h>
 
+/** @brief Where the MPU6050 offsets are kept between boots */
+#define MPU6050_CALIB_PATH "mpu6050.cal"
+
 int main() {
-  if (bme280_begin(BME280_ADDRESS_ALTERNATE) != 0) {
+  // Scan the bus and start both sensors, their start-up times overlap
+  bringup_t boot;
+  if (bringup_start(&boot) < 0) {
+    return -1;
+  }
+  if (boot.env < 0) {
     fprintf(stderr, "Error inicializando BME280\n");
     return -1;
   }
-
-  if (mpu6050_begin(MPU6050_ADDRESS) != 0) {
+  if (boot.imu < 0) {
     fprintf(stderr, "Error inicializando MPU6050\n");
     return -1;
   }
@@ -24,29 +37,77 @@ int main() {
   mpu6050_set_acce_fs(MPU6050_RANGE_4_G);
   mpu6050_set_gyro_fs(MPU6050_RANGE_500_DEG);
 
+  // Warm start from the saved offsets, calibrate only when there are none
+  mpu6050_calib_data_t calib;
+  int calibrated = mpu6050_calib_load(MPU6050_CALIB_PATH, &calib) == 0;
+
+  bringup_wait(&boot);
+  bringup_report(&boot);
+
+  if (!calibrated) {
+    printf("Calibrating MPU6050, keep the board still...\n");
+    calibrated = mpu6050_calib_run(NULL, &calib) == 0;
+    if (calibrated) {
+      mpu6050_calib_save(MPU6050_CALIB_PATH, &calib);
+    }
+  }
+  if (calibrated) {
+    mpu6050_calib_apply(&calib, MPU6050_CALIB_APPLY_DRIVER);
+  }
+
   mpu6050_acce_value_t acce;
   mpu6050_gyro_value_t gyro;
+  bme280_sample_t env;
+
+  telemetry_encoder_t telemetry;
+  telemetry_record_t record;
+  uint8_t frame[TELEMETRY_DEFAULT_PAYLOAD];
+  size_t frame_length;
+  telemetry_encoder_init(&telemetry, NULL);
+
+  // Other local processes read the latest samples from here, not the bus
+  sensor_shm_publisher_t shm;
+  int shm_ok = sensor_shm_publisher_open(&shm, NULL) == 0;
 
   uint8_t counter = 0;
   while (counter < 30) {
-    float temp = bme280_read_temperature();
-    float pressure = bme280_read_pressure();
-    float humidity = bme280_read_humidity();
+    bme280_read_sample(&env);
     float altitude = bme280_read_altitude(SEALEVELPRESSURE_HPA);
 
-    printf("[BME] Temp: %.2f Press: %.2f Hum: %.2f Alt: %.2f\n", temp, pressure,
-           humidity, altitude);
-    bcm2835_delay(100);
+    printf("[BME] T: %" PRIu64 " Temp: %.2f Press: %.2f Hum: %.2f Alt: %.2f\n",
+           env.timestamp_ns, env.temperature, env.pressure, env.humidity,
+           altitude);
+    if (shm_ok) {
+      sensor_shm_publish_env(&shm, &env);
+    }
+    i2c_tools_delay_ms(100);
     mpu6050_get_acce(&acce);
     mpu6050_get_gyro(&gyro);
-    printf("[MPU] AcceX: %.2f AcceY: %.2f AcceZ: %.2f GyroX: %.2f GyroY: %.2f "
-           "GyroZ: %.2f\n",
-           acce.acce_x, acce.acce_y, acce.acce_z, gyro.gyro_x, gyro.gyro_y,
-           gyro.gyro_z);
+    printf("[MPU] T: %" PRIu64 " AcceX: %.2f AcceY: %.2f AcceZ: %.2f "
+           "GyroX: %.2f GyroY: %.2f GyroZ: %.2f\n",
+           acce.timestamp_ns, acce.acce_x, acce.acce_y, acce.acce_z,
+           gyro.gyro_x, gyro.gyro_y, gyro.gyro_z);
+    if (shm_ok) {
+      sensor_shm_publish_acce(&shm, &acce);
+      sensor_shm_publish_gyro(&shm, &gyro);
+    }
+
+    telemetry_record_from_samples(&record, &env, &acce, &gyro);
+    if (telemetry_encoder_push(&telemetry, &record, frame, &frame_length)) {
+      printf("[TLM] Frame ready: %zu bytes\n", frame_length);
+    }
 
-    bcm2835_delay(2000);
+    i2c_tools_delay_ms(2000);
     counter++;
   }
 
+  if (telemetry_encoder_flush(&telemetry, frame, &frame_length)) {
+    printf("[TLM] Frame ready: %zu bytes\n", frame_length);
+  }
+
+  if (shm_ok) {
+    sensor_shm_publisher_close(&shm);
+  }
+  TRACE_EXPORT_JSON("coreflight.trace.json");
   return 0;
 }
\ No newline at end of file
@@ -0,0 +1,458 @@
+/**
+ * @file sensord.c
+ * @brief Sensor daemon: owns the buses and streams samples to local clients
+ *
+ * A single thread drives everything from one epoll set: two timerfds pace
+ * the MPU6050 and BME280 reads, a signalfd handles shutdown and every
+ * client is a non-blocking SOCK_SEQPACKET connection. Each bus read happens
+ * once no matter how many clients are connected; the sample is then fanned
+ * out to the subscriptions that want it, decimated and batched per client.
+ *
+ * Every client owns a bounded ring of frames. When a client does not keep
+ * up and its ring is full, the oldest queued frame is dropped and its
+ * samples are added to the client's drop counter, which is reported in
+ * every subsequent frame header. A slow client therefore never delays the
+ * acquisition or the other clients.
+ *
+ * @author Pwnsat Team
+ * @date 2026-10-18
+ * @license SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "mpu6050.h"
+#include "mpu6050_calib.h"
+#include "sensor_shm_publisher.h"
+#include "sensor_stream.h"
+#include "spi_tools.h"
+#include "trace.h"
+#include <bme280.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/** @brief Where the MPU6050 offsets are kept between boots */
+#define MPU6050_CALIB_PATH "mpu6050.cal"
+/** @brief Maximum simultaneous clients */
+#define SENSORD_MAX_CLIENTS (128)
+/** @brief Frames each client may have queued before drops start */
+#define SENSORD_QUEUE_FRAMES (16)
+/** @brief Kernel send buffer per client, keeps the queue bound meaningful */
+#define SENSORD_SOCKET_BUFFER (16384)
+/** @brief Default MPU6050 polling rate */
+#define SENSORD_IMU_HZ (100)
+/** @brief Default BME280 polling rate */
+#define SENSORD_ENV_HZ (10)
+
+/**
+ * @brief epoll tags of the fixed descriptors, clients use their index
+ */
+enum {
+  SENSORD_TAG_LISTEN = SENSORD_MAX_CLIENTS,
+  SENSORD_TAG_IMU,
+  SENSORD_TAG_ENV,
+  SENSORD_TAG_SIGNAL,
+};
+
+/**
+ * @brief Connected client
+ */
+typedef struct {
+  int fd;                        /**< Socket, -1 when the slot is free */
+  sensor_stream_subscribe_t sub; /**< Current subscription */
+  uint32_t phase[SENSOR_STREAM_CHANNELS]; /**< Decimation counters */
+  sensor_stream_frame_t *queue;  /**< Ring of SENSORD_QUEUE_FRAMES */
+  unsigned head;                 /**< Oldest complete frame */
+  unsigned count;                /**< Complete frames queued */
+  uint16_t open;                 /**< Samples in the frame being built */
+  uint32_t sequence;             /**< Frames produced */
+  uint32_t dropped;              /**< Samples dropped */
+  uint64_t sent;                 /**< Frames sent */
+  int want_out;                  /**< EPOLLOUT is armed */
+} sensord_client_t;
+
+static sensord_client_t clients[SENSORD_MAX_CLIENTS];
+static int epoll_fd = -1;
+
+static void sensord_close_client(sensord_client_t *c) {
+  printf("[SENSORD] Client %d gone: %llu frames sent, %u samples dropped\n",
+         (int)(c - clients), (unsigned long long)c->sent, c->dropped);
+  epoll_ctl(epoll_fd, EPOLL_CTL_DEL, c->fd, NULL);
+  close(c->fd);
+  free(c->queue);
+  memset(c, 0, sizeof(*c));
+  c->fd = -1;
+}
+
+static void sensord_arm_out(sensord_client_t *c, int want_out) {
+  if (c->want_out == want_out) {
+    return;
+  }
+  struct epoll_event ev = {.events = EPOLLIN | (want_out ? EPOLLOUT : 0),
+                           .data.u32 = (uint32_t)(c - clients)};
+  epoll_ctl(epoll_fd, EPOLL_CTL_MOD, c->fd, &ev);
+  c->want_out = want_out;
+}
+
+/**
+ * @brief Send queued frames until the socket buffer is full
+ * @return 0 if the client is still connected, -1 if it was closed
+ */
+static int sensord_flush(sensord_client_t *c) {
+  while (c->count > 0) {
+    sensor_stream_frame_t *frame = &c->queue[c->head];
+    size_t size = sensor_stream_frame_size(frame->header.count);
+    // SOCK_SEQPACKET sends the whole frame or nothing
+    TRACE_BEGIN(send);
+    ssize_t sent = send(c->fd, frame, size, MSG_DONTWAIT | MSG_NOSIGNAL);
+    TRACE_END(send, "stream_send", size);
+    if (sent < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        sensord_arm_out(c, 1);
+        return 0;
+      }
+      sensord_close_client(c);
+      return -1;
+    }
+    c->head = (c->head + 1) % SENSORD_QUEUE_FRAMES;
+    c->count--;
+    c->sent++;
+  }
+  sensord_arm_out(c, 0);
+  return 0;
+}
+
+/**
+ * @brief Close the frame being built and queue it for sending
+ */
+static void sensord_seal(sensord_client_t *c) {
+  unsigned tail = (c->head + c->count) % SENSORD_QUEUE_FRAMES;
+  sensor_stream_header_t *header = &c->queue[tail].header;
+  header->magic = SENSOR_STREAM_MAGIC;
+  header->count = c->open;
+  header->reserved = 0;
+  header->sequence = c->sequence++;
+  header->dropped = c->dropped;
+  c->count++;
+  c->open = 0;
+}
+
+static void sensord_append(sensord_client_t *c,
+                           const sensor_stream_sample_t *sample) {
+  if (c->open == 0 && c->count == SENSORD_QUEUE_FRAMES) {
+    // Ring full: the oldest frame makes room for fresh data
+    c->dropped += c->queue[c->head].header.count;
+    c->head = (c->head + 1) % SENSORD_QUEUE_FRAMES;
+    c->count--;
+  }
+  unsigned tail = (c->head + c->count) % SENSORD_QUEUE_FRAMES;
+  c->queue[tail].sample[c->open++] = *sample;
+  if (c->open == c->sub.batch) {
+    sensord_seal(c);
+  }
+}
+
+/**
+ * @brief Hand one bus sample to every subscription that wants it
+ */
+static void sensord_dispatch(sensor_stream_channel_t channel,
+                             uint64_t timestamp_ns, float x, float y,
+                             float z) {
+  sensor_stream_sample_t sample = {.timestamp_ns = timestamp_ns,
+                                   .channel = (uint8_t)channel,
+                                   .value = {x, y, z}};
+  TRACE_BEGIN(dispatch);
+  for (int i = 0; i < SENSORD_MAX_CLIENTS; i++) {
+    sensord_client_t *c = &clients[i];
+    if (c->fd < 0 || !(c->sub.channel_mask & SENSOR_STREAM_BIT(channel))) {
+      continue;
+    }
+    if (c->phase[channel]++ % c->sub.decimation == 0) {
+      sensord_append(c, &sample);
+    }
+  }
+  TRACE_END(dispatch, "stream_dispatch", channel);
+}
+
+/**
+ * @brief Push out whatever became ready during this loop iteration
+ */
+static void sensord_flush_all(void) {
+  for (int i = 0; i < SENSORD_MAX_CLIENTS; i++) {
+    if (clients[i].fd >= 0 && clients[i].count > 0 && !clients[i].want_out) {
+      sensord_flush(&clients[i]);
+    }
+  }
+}
+
+static void sensord_accept(int listen_fd) {
+  for (;;) {
+    int fd = accept(listen_fd, NULL, NULL);
+    if (fd < 0) {
+      return;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+    // Otherwise the kernel would silently buffer thousands of stale frames
+    int buffer = SENSORD_SOCKET_BUFFER;
+    setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &buffer, sizeof(buffer));
+    sensord_client_t *c = NULL;
+    for (int i = 0; i < SENSORD_MAX_CLIENTS && c == NULL; i++) {
+      if (clients[i].fd < 0) {
+        c = &clients[i];
+      }
+    }
+    sensor_stream_frame_t *queue =
+        c != NULL ? calloc(SENSORD_QUEUE_FRAMES, sizeof(*queue)) : NULL;
+    if (queue == NULL) {
+      fprintf(stderr, "Error accepting client: no free slot\n");
+      close(fd);
+      continue;
+    }
+    memset(c, 0, sizeof(*c));
+    c->fd = fd;
+    c->queue = queue;
+    struct epoll_event ev = {.events = EPOLLIN,
+                             .data.u32 = (uint32_t)(c - clients)};
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+    printf("[SENSORD] Client %d connected\n", (int)(c - clients));
+  }
+}
+
+/**
+ * @brief Read subscription updates from a client
+ */
+static void sensord_receive(sensord_client_t *c) {
+  sensor_stream_subscribe_t request;
+  for (;;) {
+    ssize_t length = recv(c->fd, &request, sizeof(request), MSG_DONTWAIT);
+    if (length < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return;
+    }
+    if (length != (ssize_t)sizeof(request) ||
+        request.magic != SENSOR_STREAM_MAGIC || request.batch == 0 ||
+        request.batch > SENSOR_STREAM_MAX_BATCH || request.decimation == 0) {
+      sensord_close_client(c);
+      return;
+    }
+    // Samples gathered under the old subscription still go out
+    if (c->open > 0) {
+      sensord_seal(c);
+    }
+    c->sub = request;
+    c->sub.channel_mask &= SENSOR_STREAM_ALL;
+    memset(c->phase, 0, sizeof(c->phase));
+  }
+}
+
+static int sensord_timer(uint32_t hz) {
+  int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (fd < 0) {
+    return -1;
+  }
+  long period_ns = 1000000000L / (long)hz;
+  struct itimerspec spec = {
+      .it_interval = {period_ns / 1000000000L, period_ns % 1000000000L},
+      .it_value = {period_ns / 1000000000L, period_ns % 1000000000L},
+  };
+  timerfd_settime(fd, 0, &spec, NULL);
+  return fd;
+}
+
+static int sensord_listen(const char *path) {
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (strlen(path) >= sizeof(addr.sun_path)) {
+    return -1;
+  }
+  strcpy(addr.sun_path, path);
+  unlink(path);
+
+  int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd < 0 || bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+      listen(fd, 16) != 0) {
+    fprintf(stderr, "Error listening on %s\n", path);
+    if (fd >= 0) {
+      close(fd);
+    }
+    return -1;
+  }
+  return fd;
+}
+
+static void sensord_watch(int fd, uint32_t tag) {
+  struct epoll_event ev = {.events = EPOLLIN, .data.u32 = tag};
+  epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+}
+
+int main(int argc, char **argv) {
+  const char *path = SENSOR_STREAM_DEFAULT_PATH;
+  uint32_t imu_hz = SENSORD_IMU_HZ;
+  uint32_t env_hz = SENSORD_ENV_HZ;
+  const char *env_spi = NULL;
+  int opt;
+  while ((opt = getopt(argc, argv, "s:i:e:b:")) != -1) {
+    switch (opt) {
+    case 's':
+      path = optarg;
+      break;
+    case 'i':
+      imu_hz = (uint32_t)strtoul(optarg, NULL, 10);
+      break;
+    case 'e':
+      env_hz = (uint32_t)strtoul(optarg, NULL, 10);
+      break;
+    case 'b':
+      env_spi = optarg;
+      break;
+    default:
+      fprintf(stderr,
+              "Usage: %s [-s socket] [-i imu_hz] [-e env_hz] [-b spidev]\n",
+              argv[0]);
+      return -1;
+    }
+  }
+  if (imu_hz == 0 || env_hz == 0) {
+    fprintf(stderr, "Error: rates must be positive\n");
+    return -1;
+  }
+
+  // With the BME280 on SPI the I2C bus carries IMU traffic only
+  spi_tools_t spi;
+  if (env_spi != NULL) {
+    bme280_set_bus(spi_tools_spidev(&spi, env_spi, 0));
+  }
+  if (bme280_begin(BME280_ADDRESS_ALTERNATE) != 0) {
+    fprintf(stderr, "Error inicializando BME280\n");
+    return -1;
+  }
+  if (mpu6050_begin(MPU6050_ADDRESS) != 0) {
+    fprintf(stderr, "Error inicializando MPU6050\n");
+    return -1;
+  }
+  mpu6050_set_acce_fs(MPU6050_RANGE_4_G);
+  mpu6050_set_gyro_fs(MPU6050_RANGE_500_DEG);
+  mpu6050_calib_data_t calib;
+  if (mpu6050_calib_load(MPU6050_CALIB_PATH, &calib) == 0) {
+    mpu6050_calib_apply(&calib, MPU6050_CALIB_APPLY_DRIVER);
+  }
+
+  sensor_shm_publisher_t shm;
+  int shm_ok = sensor_shm_publisher_open(&shm, NULL) == 0;
+
+  for (int i = 0; i < SENSORD_MAX_CLIENTS; i++) {
+    clients[i].fd = -1;
+  }
+
+  sigset_t mask;
+  sigemptyset(&mask);
+  sigaddset(&mask, SIGINT);
+  sigaddset(&mask, SIGTERM);
+  sigprocmask(SIG_BLOCK, &mask, NULL);
+
+  epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  int listen_fd = sensord_listen(path);
+  int imu_fd = sensord_timer(imu_hz);
+  int env_fd = sensord_timer(env_hz);
+  int signal_fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+  if (epoll_fd < 0 || listen_fd < 0 || imu_fd < 0 || env_fd < 0 ||
+      signal_fd < 0) {
+    fprintf(stderr, "Error setting up the event loop\n");
+    return -1;
+  }
+  sensord_watch(listen_fd, SENSORD_TAG_LISTEN);
+  sensord_watch(imu_fd, SENSORD_TAG_IMU);
+  sensord_watch(env_fd, SENSORD_TAG_ENV);
+  sensord_watch(signal_fd, SENSORD_TAG_SIGNAL);
+  printf("[SENSORD] Serving %s (IMU %u Hz, ENV %u Hz)\n", path, imu_hz,
+         env_hz);
+
+  struct epoll_event events[32];
+  int running = 1;
+  while (running) {
+    int n = epoll_wait(epoll_fd, events, 32, -1);
+    if (n < 0 && errno != EINTR) {
+      fprintf(stderr, "Error waiting for events\n");
+      break;
+    }
+    for (int i = 0; i < n; i++) {
+      uint32_t tag = events[i].data.u32;
+      uint64_t expirations;
+      if (tag == SENSORD_TAG_LISTEN) {
+        sensord_accept(listen_fd);
+      } else if (tag == SENSORD_TAG_IMU) {
+        // Missed ticks are not caught up, the next read is the freshest
+        if (read(imu_fd, &expirations, sizeof(expirations)) < 0) {
+          continue;
+        }
+        TRACE_INSTANT("imu_tick", expirations);
+        mpu6050_acce_value_t acce;
+        mpu6050_gyro_value_t gyro;
+        mpu6050_get_acce(&acce);
+        mpu6050_get_gyro(&gyro);
+        sensord_dispatch(SENSOR_STREAM_ACCE, acce.timestamp_ns, acce.acce_x,
+                         acce.acce_y, acce.acce_z);
+        sensord_dispatch(SENSOR_STREAM_GYRO, gyro.timestamp_ns, gyro.gyro_x,
+                         gyro.gyro_y, gyro.gyro_z);
+        if (shm_ok) {
+          sensor_shm_publish_acce(&shm, &acce);
+          sensor_shm_publish_gyro(&shm, &gyro);
+        }
+      } else if (tag == SENSORD_TAG_ENV) {
+        if (read(env_fd, &expirations, sizeof(expirations)) < 0) {
+          continue;
+        }
+        TRACE_INSTANT("env_tick", expirations);
+        bme280_sample_t env;
+        if (bme280_read_sample(&env) == 0) {
+          sensord_dispatch(SENSOR_STREAM_ENV, env.timestamp_ns,
+                           env.temperature, env.pressure, env.humidity);
+          if (shm_ok) {
+            sensor_shm_publish_env(&shm, &env);
+          }
+        }
+      } else if (tag == SENSORD_TAG_SIGNAL) {
+        running = 0;
+      } else {
+        sensord_client_t *c = &clients[tag];
+        if (c->fd < 0) {
+          continue;
+        }
+        if (events[i].events & (EPOLLHUP | EPOLLERR)) {
+          sensord_close_client(c);
+          continue;
+        }
+        if ((events[i].events & EPOLLOUT) && sensord_flush(c) != 0) {
+          continue;
+        }
+        if (events[i].events & EPOLLIN) {
+          sensord_receive(c);
+        }
+      }
+    }
+    sensord_flush_all();
+  }
+
+  for (int i = 0; i < SENSORD_MAX_CLIENTS; i++) {
+    if (clients[i].fd >= 0) {
+      sensord_close_client(&clients[i]);
+    }
+  }
+  close(listen_fd);
+  unlink(path);
+  if (shm_ok) {
+    sensor_shm_publisher_close(&shm);
+  }
+  i2c_tool_cleanup();
+  TRACE_EXPORT_JSON("sensord.trace.json");
+  return 0;
+}